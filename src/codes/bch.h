@@ -7,6 +7,7 @@
 #include <numeric>
 
 #include "codes/cyclic.h"
+#include "math/gf2_polynomial.h"
 #include "math/linear_equation_system.h"
 
 /* NOTE(hannes): padding warning, because class is empty */
@@ -19,78 +20,404 @@ template <unsigned q, typename Capability,
 class primitive_bch : public cyclic<q, Capability, Sigma, N, Coding> {
 
   using Base = cyclic<q, Capability, Sigma, N, Coding>;
+  /* Words are encoded by the packed tables below; of the encoders of cyclic
+   * only G is needed, to build the table of generator_matrix_tag. */
+  using encoder_tag = typename std::conditional<
+      std::is_same<Coding, generator_matrix_tag>::value, generator_matrix_tag,
+      coding_tag>::type;
 
 public:
   using Element = typename Base::Element;
   using Polynomial = typename Base::Polynomial;
+  using Locator = typename Base::Locator;
+  using Elements = typename Base::Elements;
+  using workspace = typename Base::workspace;
+  /* Code words with one bit per coefficient */
+  using Word = math::static_gf2_polynomial<Base::n>;
 
 private:
-  static Polynomial g() {
-    Polynomial g({ Element(1) });
+  using Minimal = math::static_gf2_polynomial<q>;
 
-    std::vector<unsigned> powers;
-    for (unsigned p = 1; p < 2 * static_cast<unsigned>(Base::t); p += 2) {
-      powers.push_back(p);
-    }
+  Word generator;
+  /* for generator_matrix_tag: row 256 i + x is the parity of the information
+   * byte x at bits [8 i, 8 i + 8) */
+  gf2_matrix parity_table;
+  /* minimal polynomials of α^1, α^3, ..., α^(2t - 1) */
+  math::static_vector<Minimal, Base::t> minimal_polynomials;
 
-    for (const auto &power : powers) {
-      auto roots = minimal_polynomial_roots(power);
-      Polynomial m{ Element(1) };
-      for (const auto &root : roots) {
-        /* build minimal polynomial */
-        m *= Polynomial{ Element::from_power(root), Element(1) };
-      }
-      g = g.lcm(m);
-    }
-    return g;
-  }
+  using constants = detail::bch_constants<q, Base::t, N>;
+  using compile_time = detail::constant_generator<q>;
 
-  static std::vector<Element> syndromes() {
-    std::vector<Element> syndromes;
-    Polynomial g_ = g();
+  static Polynomial g(std::true_type) {
+    const auto &c = constants::value;
+    return Base::to_polynomial(c.generator, c.k + 1);
+  }
 
-    for (unsigned power = 1; power < 2 * Base::t + 1; power++)
-      syndromes.push_back(Element::from_power(power));
-    return syndromes;
+  /* Beyond the fields of generator.h, g is the lcm of the minimal
+   * polynomials of α^1, α^3, ..., α^(2t - 1). */
+  static Polynomial g(std::false_type) {
+    Polynomial g_({ Element(1) });
+    for (unsigned power = 1; power < 2 * Base::t; power += 2) {
+      /* α^power is already a zero, if it is conjugate to an earlier power */
+      if (!g_(Element::from_power(power)))
+        continue;
+      g_ = g_.lcm(minimal_polynomial(power));
+    }
+    return g_;
   }
 
   /*      r - 1
    *       __
    * m_i = || (x - a^{2^j*i})
    *      j = 0
-   */
-  static std::vector<unsigned> minimal_polynomial_roots(const unsigned &i) {
-    std::vector<unsigned> roots{ i };
-
-    for (unsigned r = 1; r < q; r++) {
-      auto power = ((1 << r) * i) % Base::n;
-      if (power == i)
-        break;
-      roots.push_back(power);
+   *
+   * Doubling modulo the order of α instead of computing 2^j i, which
+   * overflows for large fields. */
+  static Polynomial minimal_polynomial(const unsigned i) {
+    constexpr unsigned order = (1u << q) - 1;
+    Polynomial m({ Element(1) });
+    unsigned power = i % order;
+    do {
+      m *= Polynomial({ Element::from_power(power), Element(1) });
+      power = (2 * power) % order;
+    } while (power != i % order);
+    return m;
+  }
+
+  static Elements syndrome_roots() {
+    Elements roots_;
+    for (unsigned power = 1; power <= 2 * Base::t; power++)
+      roots_.push_back(Element::from_power(power));
+    return roots_;
+  }
+
+  template <typename Binary, size_t Size>
+  static Binary to_binary(const detail::table<uint64_t, Size> &bits,
+                          const size_t size) {
+    Binary binary(size);
+    std::copy_n(bits.begin(), (size + 63) / 64, binary.data());
+    return binary;
+  }
+
+  /* The coefficients of g and of the minimal polynomials are 0 or 1. */
+  template <typename Binary> static Binary to_binary(const Polynomial &p) {
+    Binary binary;
+    for (const auto &coefficient : p) {
+      if (coefficient != Element(0) && coefficient != Element(1))
+        throw std::runtime_error("Polynomial is not binary.");
+      binary.push_back(coefficient == Element(1));
     }
+    return binary;
+  }
 
-    auto power = ((1 << q) * i) % Base::n;
-    if (power != i) {
-      throw std::runtime_error("Cycle seems not be finished after q elements.");
+  /* is signed */
+  template <typename InputSequence>
+  static Word pack(const InputSequence &b, std::true_type) {
+    Word b_;
+    for (const auto &e : b)
+      b_.push_back(e < 0);
+    return b_;
+  }
+
+  /* unsigned */
+  template <typename InputSequence>
+  static Word pack(const InputSequence &b, std::false_type) {
+    Word b_;
+    for (const auto &e : b)
+      b_.push_back(e != 0);
+    return b_;
+  }
+
+  /* S_j = b(α^j) = (b mod m_j)(α^j) for odd j, where m_j is the minimal
+   * polynomial of α^j, and S_2j = S_j^2. The remainders have less than q
+   * coefficients, so the word is only reduced, which is done 64 bits at a
+   * time, and never evaluated.
+   *
+   * The word is reduced modulo g first, which all m_j divide. This is the
+   * only pass over the whole word and the remainder is zero for code words,
+   * which then need no further work. */
+  Elements word_syndromes(const Word &b) const {
+    Elements syndromes(2 * Base::t, Element(0));
+    const auto r = b % generator;
+    if (!r)
+      return syndromes;
+
+    for (unsigned power = 1; power <= 2 * Base::t; power++) {
+      auto &syndrome = syndromes[power - 1];
+      if (power % 2 == 0) {
+        syndrome = syndromes[power / 2 - 1] * syndromes[power / 2 - 1];
+        continue;
+      }
+
+      const auto remainder = r % minimal_polynomials[power / 2];
+      const Element x = Element::from_power(power);
+      syndrome = Element(0);
+      for (size_t i = remainder.size(); i--;)
+        syndrome = syndrome * x + Element(remainder[i]);
+    }
+    return syndromes;
+  }
+
+  template <typename InputSequence>
+  decode_status correct_word(const InputSequence &b,
+                             const std::vector<unsigned> &erasures,
+                             Word &b_) const {
+    if (b.size() != Base::n) {
+      std::ostringstream os;
+      os << "Channel code word has the wrong size (" << b.size()
+         << "). Expected " << Base::n;
+      throw std::runtime_error(os.str());
     }
 
-    return roots;
+    if (erasures.size() > 2 * Base::t)
+      return decode_status::failure(
+          "Number of erasures exceed error correction capability.");
+
+    b_ = pack(
+        b,
+        typename std::is_signed<typename InputSequence::value_type>::type());
+
+    auto syndromes_ = word_syndromes(b_);
+    if (!std::any_of(std::cbegin(syndromes_), std::cend(syndromes_),
+                     [](const Element &e) { return bool(e); }))
+      return decode_status::corrected(0);
+
+    typename Base::Positions positions;
+    Elements values;
+    const auto status = Base::locate(syndromes_, erasures, positions, values);
+    if (!status)
+      return status;
+    for (const auto &position : positions)
+      b_.flip(position);
+
+    /* declare decoding failure - Avoid decoder malfunction */
+    if (b_ % generator)
+      return decode_status::failure("Corrected word is not a codeword");
+    return decode_status::corrected(positions.size());
   }
 
-  static std::vector<Element> error_values(const std::vector<Element> &,
-                                           const std::vector<Element> &zeroes) {
-    return std::vector<Element>(zeroes.size(), Element(1));
+  /* throws decoding_failure */
+  template <typename InputSequence>
+  Word correct_word(const InputSequence &b,
+                    const std::vector<unsigned> &erasures) const {
+    Word b_;
+    correct_word(b, erasures, b_).value();
+    return b_;
   }
 
-  template <
-      typename Return_type = typename Base::Element::storage_type,
-      typename InputSequence, typename Tag,
-      typename std::enable_if<
-          !std::is_same<Tag, peterson_gorenstein_zierler_tag>::value>::type * =
-          nullptr>
+  /* PGZ decodes erasures as zeroes and as ones and keeps the word with fewer
+   * errors. */
+  template <typename InputSequence>
+  decode_status correct_erasures(const InputSequence &b,
+                                 const std::vector<unsigned> &erasures,
+                                 Polynomial &word) const {
+    using Value = typename InputSequence::value_type;
+    if (erasures.size() > 2 * Base::t)
+      return decode_status::failure(
+          "Number of erasures exceed error correction capability.");
+
+    std::vector<Value> tmp(std::cbegin(b), std::cend(b));
+    workspace ws;
+    auto result = decode_status::failure("Erasure decoding failed.");
+    for (const auto &value : { Value(0), Value(1) }) {
+      for (const auto &erasure : erasures)
+        tmp.at(erasure) = value;
+      const auto status =
+          Base::correct_(tmp, std::vector<unsigned>{}, ws, Sigma{});
+      /* a failure is only returned if both fillings fail */
+      if (!status) {
+        if (!result)
+          result = status;
+        continue;
+      }
+      if (!result || status.errors() < result.errors()) {
+        result = status;
+        word = ws.word;
+      }
+    }
+    return result;
+  }
+
+  template <typename Return_type>
+  static std::vector<Return_type> unpack(const Word &b, const size_t size) {
+    std::vector<Return_type> r;
+    r.reserve(size);
+    for (size_t i = 0; i < size; i++)
+      r.push_back(Return_type(i < b.size() && b[i]));
+    return r;
+  }
+
+  template <typename Return_type>
+  static void unpack(const Word &b, vector_view<Return_type> out) {
+    for (size_t i = 0; i < out.size(); i++)
+      out[i] = Return_type(i < b.size() && b[i]);
+  }
+
+  /* A shift register as in CRCs with slicing-by-8, 64 information bits y at
+   * a time from the highest. With r = r_high x^(k - 64) + r_low,
+   *
+   *   x^64 r + y x^k mod g = x^64 r_low + (r_high + y) x^k mod g,
+   *
+   * and the last term is the sum of one row of the remainder table for each
+   * byte of r_high + y. Below 64 parity bits r_high is r x^(64 - k). The
+   * table is computed at compile time, or once at run time beyond the fields
+   * of generator.h. */
+  Word encode_(const Word &a, division_tag) const {
+    const auto &remainder_table = remainders(compile_time());
+    const size_t k = this->k;
+    const size_t words = (k + 63) / 64;
+    const uint64_t *information = a.data();
+    uint64_t r[Base::n / 64 + 1] = {};
+
+    for (size_t word = (a.size() + 63) / 64; word--;) {
+      uint64_t high;
+      if (k > 64) {
+        const size_t first = (k - 64) / 64;
+        const size_t shift = k % 64;
+        high = r[first] >> shift;
+        if (shift)
+          high |= r[first + 1] << (64 - shift);
+
+        for (size_t i = words - 1; i; i--)
+          r[i] = r[i - 1];
+        r[0] = 0;
+        if (shift)
+          r[words - 1] &= (uint64_t(1) << shift) - 1;
+      } else {
+        high = k ? r[0] << (64 - k) : 0;
+        r[0] = 0;
+      }
+
+      /* the rows are summed first, so r is written once per word */
+      high ^= information[word];
+      const uint64_t *rows[8];
+      for (size_t byte = 0; byte < 8; byte++, high >>= 8)
+        rows[byte] = remainder_table[256 * byte + (high & 0xff)];
+      for (size_t i = 0; i < words; i++)
+        r[i] ^= ((rows[0][i] ^ rows[1][i]) ^ (rows[2][i] ^ rows[3][i])) ^
+                ((rows[4][i] ^ rows[5][i]) ^ (rows[6][i] ^ rows[7][i]));
+    }
+
+    auto c = a << k;
+    uint64_t *parity = c.data();
+    for (size_t i = 0; i < words; i++)
+      parity[i] ^= r[i];
+    return c;
+  }
+
+  Word encode_(const Word &a, multiplication_tag) const {
+    return a * generator;
+  }
+
+  /* The parity is the sum of one table row per byte of information. */
+  Word encode_(const Word &a, generator_matrix_tag) const {
+    auto c = a << this->k;
+    uint64_t *parity = c.data();
+    const uint64_t *information = a.data();
+    const size_t words = parity_table.words();
+    const size_t bytes = (a.size() + 7) / 8;
+    for (size_t byte = 0; byte < bytes; byte++) {
+      const auto x = (information[byte / 8] >> (8 * (byte % 8))) & 0xff;
+      if (!x)
+        continue;
+      const uint64_t *row = parity_table[256 * byte + x];
+      for (size_t word = 0; word < words; word++)
+        parity[word] ^= row[word];
+    }
+    return c;
+  }
+
+  static const detail::bch_remainders<q, Base::t, N> &
+  remainders(std::true_type) {
+    return detail::bch_remainder_table<q, Base::t, N>::value;
+  }
+
+  /* Row 256 i + y is y x^(k + 8 i) mod g. The rows of the bits are
+   * x^(k + j) mod g, the others their sums. */
+  const gf2_matrix &remainders(std::false_type) const {
+    static const gf2_matrix table = [](const Word &generator_) {
+      const auto k = static_cast<size_t>(generator_.degree());
+      gf2_matrix rows(8 * 256, k);
+      for (size_t j = 0; j < 64; j++) {
+        math::gf2_polynomial<> x_k(k + j + 1);
+        x_k.set(k + j, true);
+        const auto r = x_k % generator_;
+        for (size_t i = 0; i < k && i < r.size(); i++)
+          rows.set(256 * (j / 8) + (size_t(1) << (j % 8)), i, r[i]);
+      }
+
+      for (size_t byte = 0; byte < 8; byte++) {
+        for (size_t y = 3; y < 256; y++) {
+          const size_t low = y & (0 - y);
+          if (y == low)
+            continue;
+          const uint64_t *previous = rows[256 * byte + (y ^ low)];
+          const uint64_t *row = rows[256 * byte + low];
+          uint64_t *entry = rows[256 * byte + y];
+          for (size_t word = 0; word < rows.words(); word++)
+            entry[word] = previous[word] ^ row[word];
+        }
+      }
+      return rows;
+    }(generator);
+    return table;
+  }
+
+  static gf2_matrix parity_table_for(const generator_matrix<Polynomial> &,
+                                     coding_tag) {
+    return gf2_matrix();
+  }
+
+  /* Entry x of a byte is entry x without its lowest set bit plus the parity
+   * row of that bit. */
+  static gf2_matrix parity_table_for(const generator_matrix<Polynomial> &G,
+                                     generator_matrix_tag) {
+    const size_t l = G.rows();
+    const size_t k = G.columns() - l;
+    gf2_matrix rows(l, k);
+    for (size_t i = 0; i < l; i++) {
+      const Element *row = G.parity(i);
+      for (size_t j = 0; j < k; j++)
+        rows.set(i, j, row[j] == Element(1));
+    }
+
+    const size_t bytes = (l + 7) / 8;
+    gf2_matrix table(256 * bytes, k);
+    for (size_t byte = 0; byte < bytes; byte++) {
+      for (size_t x = 1; x < 256; x++) {
+        const size_t i = 8 * byte + static_cast<size_t>(__builtin_ctzll(x));
+        if (i >= l)
+          continue;
+        const uint64_t *previous = table[256 * byte + (x & (x - 1))];
+        const uint64_t *row = rows[i];
+        uint64_t *entry = table[256 * byte + x];
+        for (size_t word = 0; word < table.words(); word++)
+          entry[word] = previous[word] ^ row[word];
+      }
+    }
+    return table;
+  }
+
+  Word decode_(const Word &b, division_tag) const { return b >> this->k; }
+
+  Word decode_(const Word &b, generator_matrix_tag) const {
+    return b >> this->k;
+  }
+
+  Word decode_(const Word &b, multiplication_tag) const {
+    return b / generator;
+  }
+
+  static Elements error_values(const Elements &, const Locator &,
+                               const Elements &zeroes) {
+    return Elements(zeroes.size(), Element(1));
+  }
+
+  template <typename Return_type = typename Base::Element::storage_type,
+            typename InputSequence>
   std::vector<Return_type> correct(const InputSequence &b,
                                    const std::vector<unsigned> &erasures,
-                                   Tag) const {
+                                   soft_decision_tag) const {
     return Base::template correct<Return_type>(b, erasures);
   }
 
@@ -98,48 +425,82 @@ private:
             typename InputSequence>
   std::vector<Return_type> correct(const InputSequence &b,
                                    const std::vector<unsigned> &erasures,
-                                   peterson_gorenstein_zierler_tag) const {
-    if (erasures.empty()) {
-      return Base::template correct<Return_type>(b, erasures);
-    } else {
-      if (erasures.size() > 2 * Base::t)
-        throw decoding_failure(
-            "Number of erasures exceed error correction capability.");
+                                   hard_decision_tag) const {
+    return unpack<Return_type>(correct_word(b, erasures), Base::n);
+  }
 
-      auto tmp(b);
+  template <typename InputSequence, typename Return_type>
+  decode_status correct_into(const InputSequence &b,
+                             vector_view<Return_type> out, workspace &ws,
+                             const std::vector<unsigned> &erasures,
+                             soft_decision_tag) const {
+    return Base::correct_into(b, out, ws, erasures);
+  }
 
-      std::vector<std::pair<Polynomial, size_t> > results;
+  /* Words are packed on the stack, so ws is not needed. */
+  template <typename InputSequence, typename Return_type>
+  decode_status correct_into(const InputSequence &b,
+                             vector_view<Return_type> out, workspace &,
+                             const std::vector<unsigned> &erasures,
+                             hard_decision_tag) const {
+    if (out.size() != Base::n) {
+      std::ostringstream os;
+      os << "Output word has the wrong size (" << out.size() << "). Expected "
+         << Base::n;
+      throw std::runtime_error(os.str());
+    }
+    Word b_;
+    const auto status = correct_word(b, erasures, b_);
+    if (status)
+      unpack(b_, out);
+    return status;
+  }
 
-      try {
-        for (const auto &erasure : erasures)
-          tmp.at(erasure) = typename InputSequence::value_type(0);
-        results.push_back(Base::template correct_<Return_type>(
-            tmp, std::vector<unsigned>{}, Sigma{}));
-      }
-      catch (const decoding_failure &e) {
-        std::cout << e.what() << std::endl;
-      }
+  /* erasures are decoded on copies, which allocates */
+  template <typename InputSequence, typename Return_type>
+  decode_status correct_into(const InputSequence &b,
+                             vector_view<Return_type> out, workspace &ws,
+                             const std::vector<unsigned> &erasures,
+                             peterson_gorenstein_zierler_tag) const {
+    if (erasures.empty())
+      return correct_into(b, out, ws, erasures, hard_decision_tag{});
+    if (out.size() != b.size())
+      throw std::runtime_error("Output word has the wrong size.");
 
-      try {
-        for (const auto &erasure : erasures)
-          tmp.at(erasure) = typename InputSequence::value_type(1);
-        results.push_back(Base::template correct_<Return_type>(
-            tmp, std::vector<unsigned>{}, Sigma{}));
-      }
-      catch (const decoding_failure &e) {
-        std::cout << e.what() << std::endl;
-      }
+    Polynomial word;
+    const auto status = correct_erasures(b, erasures, word);
+    if (status)
+      std::transform(std::cbegin(word), std::cend(word), std::begin(out),
+                     [](const auto &e) { return Return_type(e); });
+    return status;
+  }
 
-      if (results.empty()) {
-        throw decoding_failure("Erasure decoding failed.");
-      }
+  template <typename Return_type, typename InputSequence>
+  std::vector<Return_type> decode(const InputSequence &b,
+                                  const std::vector<unsigned> &erasures,
+                                  soft_decision_tag) const {
+    return Base::template decode<InputSequence, Return_type>(b, erasures);
+  }
+
+  template <typename Return_type, typename InputSequence>
+  std::vector<Return_type> decode(const InputSequence &b,
+                                  const std::vector<unsigned> &erasures,
+                                  hard_decision_tag) const {
+    return unpack<Return_type>(decode_(correct_word(b, erasures), Coding()),
+                               this->l);
+  }
 
-      /* order by number of errors, ascending */
-      std::sort(std::begin(results), std::end(results),
-                [](const auto &lhs,
-                   const auto &rhs) { return lhs.second < rhs.second; });
+  template <typename Return_type = typename Base::Element::storage_type,
+            typename InputSequence>
+  std::vector<Return_type> correct(const InputSequence &b,
+                                   const std::vector<unsigned> &erasures,
+                                   peterson_gorenstein_zierler_tag) const {
+    if (erasures.empty()) {
+      return correct<Return_type>(b, erasures, hard_decision_tag{});
+    } else {
+      Polynomial poly;
+      correct_erasures(b, erasures, poly).value();
 
-      const auto &poly = results.front().first;
       std::vector<Return_type> r;
       r.reserve(b.size());
       std::transform(std::cbegin(poly), std::cend(poly), std::back_inserter(r),
@@ -148,8 +509,63 @@ private:
     }
   }
 
+  primitive_bch(Polynomial g_, std::true_type)
+      : Base(std::move(g_),
+             Base::to_polynomial(constants::value.check,
+                                 N - constants::value.k + 1),
+             Base::to_elements(constants::value.roots),
+             constants::value.designed_distance, &error_values,
+             encoder_tag()),
+        generator(to_binary<Word>(constants::value.generator,
+                                  constants::value.k + 1)),
+        parity_table(parity_table_for(Base::systematic, Coding())) {
+    for (const auto &m : constants::value.minimal) {
+      const auto size = static_cast<size_t>(64 - __builtin_clzll(m));
+      minimal_polynomials.push_back(
+          to_binary<Minimal>(detail::table<uint64_t, 1>{ { m } }, size));
+    }
+  }
+
+  primitive_bch(Polynomial g_, std::false_type)
+      : Base(g_, Base::f / g_, syndrome_roots(),
+             Base::consecutive_zeroes(g_) + 1, &error_values, encoder_tag()),
+        generator(to_binary<Word>(g_)),
+        parity_table(parity_table_for(Base::systematic, Coding())) {
+    for (unsigned power = 1; power < 2 * Base::t; power += 2)
+      minimal_polynomials.push_back(
+          to_binary<Minimal>(minimal_polynomial(power)));
+  }
+
 public:
-  primitive_bch() : Base(g(), syndromes(), &error_values) {}
+  primitive_bch() : primitive_bch(g(compile_time()), compile_time()) {}
+
+  /* Binary versions of cyclic::encode() and cyclic::decode(), which work on
+   * whole words of coefficients. */
+  template <typename InputSequence, typename OutputIterator>
+  void encode(const InputSequence &a, OutputIterator &&out) const {
+    if (a.size() != this->l) {
+      std::ostringstream os;
+      os << "Source code word has wrong length (" << a.size() << "). Expected "
+         << this->l;
+      throw std::runtime_error(os.str());
+    }
+
+    const auto enc = encode_(pack(a, std::false_type()), Coding());
+    size_t i = 0;
+    std::generate_n(out, Base::n, [&]() {
+      const bool bit = i < enc.size() && enc[i];
+      i++;
+      return typename InputSequence::value_type(bit);
+    });
+  }
+
+  template <typename InputSequence,
+            typename Return_type = typename InputSequence::value_type>
+  std::vector<Return_type> decode(const InputSequence &b,
+                                  const std::vector<unsigned> &erasures =
+                                      std::vector<unsigned>()) const {
+    return decode<Return_type>(b, erasures, Sigma{});
+  }
 
   template <typename Return_type = typename Base::Element::storage_type,
             typename InputSequence>
@@ -158,6 +574,17 @@ public:
                                        std::vector<unsigned>()) const {
     return correct<Return_type>(b, erasures, Sigma{});
   }
+
+  /* correct() into the n elements of out, with the buffers of ws. Decoding
+   * failures are returned instead of thrown; out is only written if decoding
+   * succeeds. */
+  template <typename InputSequence, typename Return_type>
+  decode_status
+  correct_into(const InputSequence &b, vector_view<Return_type> out,
+               workspace &ws, const std::vector<unsigned> &erasures =
+                                  std::vector<unsigned>()) const {
+    return correct_into(b, out, ws, erasures, Sigma{});
+  }
 };
 #pragma clang diagnostic pop
 }
@@ -3,6 +3,8 @@
 #include <stdexcept>
 #include <numeric>
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 
 template <unsigned e> struct errors {
   static constexpr unsigned value = e;
@@ -35,6 +37,37 @@ public:
   decoding_failure &operator=(decoding_failure &&);
 };
 
+/* The outcome of decoding a word without exceptions: the number of corrected
+ * errors or a detected decoding failure. The reason of a failure is a string
+ * literal, so failing costs no more than succeeding. */
+class decode_status {
+  const char *reason_ = nullptr;
+  size_t errors_ = 0;
+
+  constexpr decode_status(const char *reason, const size_t errors) noexcept
+      : reason_(reason), errors_(errors) {}
+
+public:
+  static constexpr decode_status corrected(const size_t errors) noexcept {
+    return decode_status(nullptr, errors);
+  }
+  static constexpr decode_status failure(const char *reason) noexcept {
+    return decode_status(reason, 0);
+  }
+
+  /* false for decoding failures */
+  constexpr explicit operator bool() const noexcept { return !reason_; }
+  constexpr size_t errors() const noexcept { return errors_; }
+  constexpr const char *reason() const noexcept { return reason_; }
+
+  /* the number of errors, for the throwing interfaces */
+  size_t value() const {
+    if (reason_)
+      throw decoding_failure(reason_);
+    return errors_;
+  }
+};
+
 struct algorithm_tag {};
 
 struct hard_decision_tag : algorithm_tag {};
@@ -50,3 +83,16 @@ void hard_decision(InputIterator first, InputIterator last,
 #endif
   std::transform(first, last, out, [](const auto &e) { return T(e < 0); });
 }
+
+/* Hard decision of [first, last) into bit i % 64 of words[i / 64]. The bits
+ * past last in the final word are cleared. */
+template <typename InputIterator>
+void pack_hard_decision(InputIterator first, InputIterator last,
+                        uint64_t *words) {
+  while (first != last) {
+    uint64_t word = 0;
+    for (unsigned bit = 0; bit < 64 && first != last; bit++, ++first)
+      word |= uint64_t(*first < 0) << bit;
+    *words++ = word;
+  }
+}
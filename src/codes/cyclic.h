@@ -4,13 +4,18 @@
 #include <utility>
 #include <cassert>
 #include <functional>
+#include <memory>
+#include <mutex>
 
 #include "codes.h"
 
 #include "math/matrix.h"
 #include "math/polynomial.h"
 #include "math/galois.h"
+#include "math/kernels.h"
+#include "math/static_vector.h"
 
+#include "generator.h"
 #include "hard_decision.h"
 #include "soft_decision.h"
 
@@ -22,6 +27,12 @@ struct multiplication_tag : coding_tag {};
 struct division_tag : coding_tag {};
 struct generator_matrix_tag : coding_tag {};
 
+struct parity_check_tag {};
+/* rows are cyclic shifts of the reversed check polynomial h, H() */
+struct check_polynomial_tag : parity_check_tag {};
+/* rows are the bits of the odd powers α^(j (2i + 1)), H_alt() */
+struct binary_roots_tag : parity_check_tag {};
+
 struct error_values_tag {};
 struct naive_tag : error_values_tag {};
 struct forney_tag : error_values_tag {};
@@ -32,10 +43,17 @@ Polynomial encode(const Polynomial &g, const Polynomial &a,
   return a * g;
 }
 
+/* a * x^k, by shifting instead of multiplying */
+template <typename Polynomial>
+Polynomial shift(const Polynomial &a, const size_t k) {
+  Polynomial x_k(k, typename Polynomial::coefficient_type(0));
+  std::copy(std::cbegin(a), std::cend(a), std::back_inserter(x_k));
+  return x_k;
+}
+
 template <typename Polynomial>
 Polynomial encode(const Polynomial &g, const Polynomial &a, division_tag) {
-  /* a * x^k */
-  auto x_k = a * Polynomial::n(static_cast<size_t>(g.degree()));
+  auto x_k = shift(a, static_cast<size_t>(g.degree()));
   return x_k + (x_k % g);
 }
 
@@ -45,20 +63,221 @@ Polynomial decode(const Polynomial &g, const Polynomial &b,
   return b / g;
 }
 
+/* the information is in the highest l coefficients */
 template <typename Polynomial>
 Polynomial decode(const Polynomial &g, const Polynomial &b, division_tag) {
-  return b / Polynomial::n(static_cast<size_t>(g.degree()));
+  const auto k = static_cast<size_t>(g.degree());
+  if (b.size() <= k)
+    return Polynomial(1, typename Polynomial::coefficient_type(0));
+  return Polynomial(std::cbegin(b) + static_cast<ssize_t>(k), std::cend(b));
+}
+
+/* Systematic encoding by a linear feedback shift register with the taps of g,
+ * as in table-driven CRCs. The register holds the remainder x^k a mod g of the
+ * information symbols shifted in so far, highest degree first. Shifting in a
+ * symbol a_j is
+ *
+ *   r = x r + a_j x^k mod g = (r << 1) + f x^k mod g,   f = a_j + r_(k - 1)
+ *
+ * and x^k mod g = -g_low / g_k, so each symbol adds one row f x^k mod g. For
+ * fields of up to 256 elements all rows are tabulated, so a symbol costs k
+ * additions and no multiplication; larger fields multiply the row with the
+ * axpy kernel. Instead of shifting, the register is a window that slides down
+ * the code word by one symbol per information symbol, and every row is added
+ * to k contiguous symbols. */
+template <typename Polynomial> class lfsr {
+  using Coefficient = typename Polynomial::coefficient_type;
+  using storage_type = typename Coefficient::storage_type;
+  /* up to GF(2^8) */
+  static constexpr unsigned max_table_digits = 8;
+
+  /* x^k mod g */
+  std::vector<Coefficient> feedback;
+  /* row f is f x^k mod g, if the field is small enough */
+  matrix<Coefficient> table;
+  size_t k = 0;
+
+  /* [r, r + k) += f x^k mod g */
+  void add(Coefficient *r, const Coefficient &f) const {
+    if (!table.rows()) {
+      math::kernel::axpy(r, r + k, feedback.data(), f);
+      return;
+    }
+    const Coefficient *row = table[static_cast<size_t>(f)].data();
+    for (size_t i = 0; i < k; i++)
+      r[i] = r[i] + row[i];
+  }
+
+public:
+  lfsr() = default;
+  explicit lfsr(const Polynomial &g)
+      : feedback(static_cast<size_t>(g.degree())),
+        k(static_cast<size_t>(g.degree())) {
+    const Coefficient lead_inverse = g[k].inverse();
+    for (size_t i = 0; i < k; i++)
+      feedback[i] = Coefficient(0) - g[i] * lead_inverse;
+
+    if (Coefficient::digits > max_table_digits)
+      return;
+    /* f x^k mod g is linear in f, so only the rows of single bits are
+     * products and the others sums of two rows */
+    const size_t size = size_t(1) << Coefficient::digits;
+    table = matrix<Coefficient>(size, k);
+    for (size_t f = 1; f < size; f++) {
+      Coefficient *row = table[f].data();
+      const size_t low = f & (0 - f);
+      if (f == low) {
+        const Coefficient f_(static_cast<storage_type>(f),
+                             math::gf::unchecked_tag{});
+        std::transform(std::cbegin(feedback), std::cend(feedback), row,
+                       [&](const Coefficient &e) { return e * f_; });
+      } else {
+        std::transform(table[f ^ low].data(), table[f ^ low].data() + k,
+                       table[low].data(), row, std::plus<Coefficient>());
+      }
+    }
+  }
+
+  size_t degree() const noexcept { return k; }
+
+  /* x^k a + (x^k a mod g) */
+  Polynomial encode(const Polynomial &a) const {
+    Polynomial c(k + a.size(), Coefficient(0));
+    Coefficient *r = c.data();
+    /* after a_j the register is [r + j, r + j + k) */
+    for (size_t j = a.size(); k && j--;) {
+      const Coefficient f = a[j] + r[j + k];
+      if (f)
+        add(r + j, f);
+    }
+    std::copy(std::cbegin(a), std::cend(a), r + k);
+    return c;
+  }
+};
+
+template <typename Polynomial>
+Polynomial encode(const lfsr<Polynomial> &g, const Polynomial &a,
+                  division_tag) {
+  return g.encode(a);
+}
+
+
+/* The systematic generator matrix G = [P | I] of a cyclic code of length n
+ * with generator polynomial g of degree k. Row i is the code word
+ * x^(k + i) - (x^(k + i) mod g), so that information symbol a_i is at position
+ * k + i and the parity of a is Σ a_i P_i, as with division_tag. The rows P_i
+ * are computed once, each from the previous one by one multiplication by x
+ * modulo g. */
+template <typename Polynomial> class generator_matrix {
+  using Coefficient = typename Polynomial::coefficient_type;
+
+  /* P, l x k */
+  matrix<Coefficient> parity_;
+  size_t k = 0;
+  size_t l = 0;
+
+public:
+  generator_matrix() = default;
+  generator_matrix(const Polynomial &g, const size_t n)
+      : parity_(n - static_cast<size_t>(g.degree()),
+                static_cast<size_t>(g.degree())),
+        k(static_cast<size_t>(g.degree())), l(n - k) {
+    if (!l)
+      return;
+
+    /* x^k = -g_low / g_k mod g */
+    const Coefficient lead_inverse = g[k].inverse();
+    Coefficient *row = parity_[0].data();
+    for (size_t j = 0; j < k; j++)
+      row[j] = g[j] * lead_inverse;
+
+    for (size_t i = 1; i < l; i++) {
+      const Coefficient *previous = parity_[i - 1].data();
+      Coefficient *next = parity_[i].data();
+      /* x * previous - carry * g / g_k */
+      const Coefficient carry = previous[k - 1] * lead_inverse;
+      next[0] = Coefficient(0);
+      std::copy(previous, previous + k - 1, next + 1);
+      math::kernel::axpy(next, next + k, g.data(), Coefficient(0) - carry);
+    }
+  }
+
+  size_t rows() const noexcept { return l; }
+  size_t columns() const noexcept { return k + l; }
+
+  /* row i of P */
+  const Coefficient *parity(const size_t i) const noexcept {
+    return parity_[i].data();
+  }
+
+  /* the code word of a, information symbols at the positions [k, n) */
+  Polynomial encode(const Polynomial &a) const {
+    Polynomial c(k, Coefficient(0));
+    const size_t size = std::min(a.size(), l);
+    for (size_t i = 0; i < size; i++)
+      math::kernel::axpy(c.data(), c.data() + k, parity(i), a[i]);
+    std::copy(std::cbegin(a), std::cbegin(a) + static_cast<ssize_t>(size),
+              std::back_inserter(c));
+    return c;
+  }
+
+  /* l x n */
+  template <typename T> matrix<T> G() const {
+    matrix<T> result(l, k + l);
+    for (size_t i = 0; i < l; i++) {
+      T *out = result[i].data();
+      const Coefficient *row = parity(i);
+      std::transform(row, row + k, out,
+                     [](const Coefficient &e) { return T(e); });
+      out[k + i] = T(Coefficient(1));
+    }
+    return result;
+  }
+
+  /* k x n, [I | -P^T], so that G H^T = 0 */
+  template <typename T> matrix<T> H() const {
+    matrix<T> result(k, k + l);
+    for (size_t j = 0; j < k; j++)
+      result(j, j) = T(Coefficient(1));
+    for (size_t i = 0; i < l; i++) {
+      const Coefficient *row = parity(i);
+      for (size_t j = 0; j < k; j++)
+        result(j, k + i) = T(Coefficient(0) - row[j]);
+    }
+    return result;
+  }
+};
+
+template <typename Polynomial>
+Polynomial encode(const generator_matrix<Polynomial> &G, const Polynomial &a,
+                  generator_matrix_tag) {
+  return G.encode(a);
+}
+
+/* the information is in the highest l coefficients */
+template <typename Polynomial>
+Polynomial decode(const generator_matrix<Polynomial> &G, const Polynomial &b,
+                  generator_matrix_tag) {
+  const auto k = G.columns() - G.rows();
+  if (b.size() <= k)
+    return Polynomial(1, typename Polynomial::coefficient_type(0));
+  return Polynomial(std::cbegin(b) + static_cast<ssize_t>(k), std::cend(b));
+}
+
+template <typename Polynomial, typename Roots, typename Syndromes>
+void calculate_syndromes(const Polynomial &b, const Roots &roots,
+                         Syndromes &syndromes) {
+  syndromes.resize(roots.size());
+  math::kernel::horner(b.data(), b.data() + b.size(), roots.data(),
+                       roots.data() + roots.size(), syndromes.data());
 }
 
 template <typename Polynomial,
           typename Element = typename Polynomial::coefficient_type>
 std::vector<Element> calculate_syndromes(const Polynomial &b,
-                                         const std::vector<Element> roots) {
+                                         const std::vector<Element> &roots) {
   std::vector<Element> syndromes;
-  for (const auto &root : roots) {
-    syndromes.push_back(b(root));
-  }
-
+  calculate_syndromes(b, roots, syndromes);
   return syndromes;
 }
 
@@ -75,7 +294,9 @@ class cyclic {
 
   static_assert(
       std::is_base_of<algorithm_tag, Algorithm>::value,
-      "Algorithm must be peterson_tag, berlekamp_massey_tag, or euklid_tag");
+      "Algorithm must be peterson_tag, berlekamp_massey_tag, "
+      "simplified_berlekamp_massey_tag, "
+      "reformulated_inversionless_berlekamp_massey_tag, or euklid_tag");
 
   static_assert(std::is_base_of<error_values_tag, Error>::value,
                 "Error must be naive_tag or forney_tag.");
@@ -90,16 +311,26 @@ public:
 
   using Element = math::ef_element<2, q>;
   using extension_field = typename Element::field_type;
-  using Polynomial = math::polynomial<Element>;
   static constexpr unsigned n = N;
   static constexpr unsigned t = correction_capability<Capability>::value;
 
+  /* Code words live on the stack, unless they get too large for it. */
+  using Polynomial = typename std::conditional<
+      (n + 1) * sizeof(Element) <= 16384, math::static_polynomial<Element, n>,
+      math::polynomial<Element> >::type;
+  /* Error locator and evaluator polynomials have a degree below 4t, even with
+   * 2t erasures. */
+  using Locator = math::static_polynomial<Element, 4 * t>;
+  /* Syndromes, zeroes of the error locator and error values. */
+  using Elements = math::static_vector<Element, 2 * t>;
+  using Positions = math::static_vector<unsigned, 2 * t>;
+
   static const Polynomial f;
 
 protected:
   Polynomial g;
   Polynomial h;
-  std::vector<Element> roots;
+  Elements roots;
 
   unsigned k;
   unsigned l;
@@ -112,9 +343,42 @@ public:
 #pragma clang diagnostic pop
 
 protected:
-  using error_value_function = std::function<std::vector<Element>(
-      const std::vector<Element> &, const std::vector<Element> &)>;
+  /* the error values from the syndromes, Σ(x) and its zeroes */
+  using error_value_function = std::function<Elements(
+      const Elements &, const Locator &, const Elements &)>;
   error_value_function error_values;
+  /* G and H in systematic form, for generator_matrix_tag only */
+  generator_matrix<Polynomial> systematic;
+  lfsr<Polynomial> shift_register;
+
+public:
+  using parity_checks =
+      parity_check_matrix<typename Element::storage_type>;
+
+  /* Scratch space of one decoding thread for correct_into(). Its buffers are
+   * reused, so that decoding does not allocate memory once they have grown,
+   * as long as search() finds the zeroes of Σ(x) in closed form or by the
+   * Chien search. The Berlekamp trace algorithm and the additive FFT allocate
+   * their own. */
+  struct workspace {
+    Polynomial word;
+    /* the received word with zeroed erasures, for soft decision decoding */
+    std::vector<float> soft;
+    min_sum_workspace<float, float, typename Element::storage_type> messages;
+  };
+
+protected:
+  /* Both forms of H, built on first use and shared by copies of the code */
+  struct parity_check_cache {
+    std::once_flag polynomial_once;
+    std::once_flag roots_once;
+    std::shared_ptr<const parity_checks> polynomial;
+    std::shared_ptr<const parity_checks> roots;
+  };
+  std::shared_ptr<parity_check_cache> checks =
+      std::make_shared<parity_check_cache>();
+  /* the H soft decision decoding uses, that of check_polynomial_tag if empty */
+  std::shared_ptr<const parity_checks> soft_checks;
 
 private:
   static Polynomial init_f() {
@@ -122,36 +386,110 @@ private:
     return Polynomial::n(n) + Element(1);
   }
 
-  /* TODO: implement & benchmark chien search */
-  std::vector<Element> zeroes(const Polynomial &sigma) const {
-    auto zeroes =
-        math::gf::roots<extension_field>(sigma, math::gf::brute_force_tag{});
+  static generator_matrix<Polynomial> systematic_form(const Polynomial &,
+                                                      coding_tag) {
+    return generator_matrix<Polynomial>();
+  }
+
+  static generator_matrix<Polynomial> systematic_form(const Polynomial &g_,
+                                                      generator_matrix_tag) {
+    return generator_matrix<Polynomial>(g_, n);
+  }
 
-    std::sort(std::begin(zeroes), std::end(zeroes));
-    auto last = std::unique(std::begin(zeroes), std::end(zeroes));
-    zeroes.erase(last, std::end(zeroes));
+  static lfsr<Polynomial> shift_register_form(const Polynomial &, coding_tag) {
+    return lfsr<Polynomial>();
+  }
 
-    if (static_cast<long>(zeroes.size()) != sigma.degree()) {
-      std::ostringstream os;
-      os << "Σ(x) has to have " << sigma.degree() << " zeroes, but it has "
-         << zeroes.size() << "." << std::endl;
-      os << sigma << " sigma(x) = 0: ";
-      for (const auto &zero :
-           math::gf::roots<extension_field>(sigma, math::gf::brute_force_tag{}))
-        os << zero << " ";
-      throw decoding_failure(os.str());
-    }
+  static lfsr<Polynomial> shift_register_form(const Polynomial &g_,
+                                              division_tag) {
+    return lfsr<Polynomial>(g_);
+  }
+
+  template <typename Tag>
+  const std::shared_ptr<const parity_checks> &
+  parity_check(std::once_flag &once, std::shared_ptr<const parity_checks> &H_,
+               Tag tag) const {
+    std::call_once(once, [&]() {
+      H_ = std::make_shared<const parity_checks>(
+          parity_check_form<typename Element::storage_type>(tag));
+    });
+    return H_;
+  }
 
-    if (std::none_of(std::begin(zeroes), std::end(zeroes),
+  template <typename T>
+  matrix<T> parity_check_form(check_polynomial_tag) const {
+    return H<T>();
+  }
+
+  template <typename T> matrix<T> parity_check_form(binary_roots_tag) const {
+    return H_alt<T>();
+  }
+
+  const Polynomial &coder(coding_tag) const { return g; }
+
+  const lfsr<Polynomial> &coder(division_tag) const { return shift_register; }
+
+  const generator_matrix<Polynomial> &coder(generator_matrix_tag) const {
+    return systematic;
+  }
+
+  /* Decoding only needs g, also where the encoder is not built, e.g. the LFSR
+   * of primitive_bch */
+  const Polynomial &decoder(coding_tag) const { return g; }
+
+  const generator_matrix<Polynomial> &decoder(generator_matrix_tag) const {
+    return systematic;
+  }
+
+  /* The closed form is cheapest up to degree 4. The Berlekamp trace algorithm
+   * costs about 16 q deg(Σ) multiply-adds per zero, the Chien search about
+   * 2^q; the faster one is chosen. The additive FFT evaluates the whole field
+   * in about the time the Chien search needs for 32 coefficients. */
+  static Elements search(const Locator &sigma) {
+    using fft_tag =
+        typename std::conditional<(q <= 24), math::gf::additive_fft_tag,
+                                  math::gf::chien_tag>::type;
+    const auto degree = sigma.degree();
+    if (degree <= 4)
+      return math::gf::roots<extension_field, Element, Elements>(
+          sigma, math::gf::closed_form_tag{});
+    if (16 * q * static_cast<size_t>(degree) < (size_t(1) << q) - 1)
+      return math::gf::roots<extension_field, Element, Elements>(
+          sigma, math::gf::berlekamp_trace_tag{});
+    if (degree >= 32)
+      return math::gf::roots<extension_field, Element, Elements>(
+          sigma, fft_tag{});
+    return math::gf::roots<extension_field, Element, Elements>(
+        sigma, math::gf::chien_tag{});
+  }
+
+  /* the distinct zeroes of Σ(x), if there are deg Σ of them */
+  static decode_status zeroes(const Locator &sigma, Elements &zeroes_) {
+    if (sigma.degree() < 0)
+      return decode_status::failure("Σ(x) could not be determined.");
+    if (sigma.degree() > static_cast<ssize_t>(Elements::capacity()))
+      return decode_status::failure(
+          "Σ(x) has more zeroes than correctable errors.");
+
+    zeroes_ = search(sigma);
+
+    std::sort(std::begin(zeroes_), std::end(zeroes_));
+    auto last = std::unique(std::begin(zeroes_), std::end(zeroes_));
+    zeroes_.erase(last, std::end(zeroes_));
+
+    if (static_cast<long>(zeroes_.size()) != sigma.degree())
+      return decode_status::failure(
+          "Σ(x) has fewer distinct zeroes than its degree.");
+
+    if (std::none_of(std::begin(zeroes_), std::end(zeroes_),
                      [](const Element &zero) { return bool(zero); }))
-      throw decoding_failure("0 is zero in Σ(x)");
+      return decode_status::failure("0 is zero in Σ(x)");
 
-    return zeroes;
+    return decode_status::corrected(zeroes_.size());
   }
 
-  std::vector<unsigned>
-  error_positions(const std::vector<Element> &zeroes) const {
-    std::vector<unsigned> error_positions;
+  Positions error_positions(const Elements &zeroes) const {
+    Positions error_positions;
     for (const auto &zero : zeroes)
       error_positions.push_back(zero.power());
 
@@ -161,54 +499,93 @@ private:
   /* TODO: select functor on signedness */
   /* is signed */
   template <typename InputSequence>
-  Polynomial sequence_to_polynomial(const InputSequence &b,
-                                    std::true_type) const {
-    Polynomial b_;
+  void sequence_to_polynomial(const InputSequence &b, Polynomial &b_,
+                              std::true_type) const {
+    b_.clear();
     b_.reserve(n);
     hard_decision<typename Polynomial::coefficient_type>(
         std::cbegin(b), std::cend(b), std::back_inserter(b_));
-    return b_;
   }
 
   /* unsigned */
   template <typename InputSequence>
-  Polynomial sequence_to_polynomial(const InputSequence &b,
-                                    std::false_type) const {
-    Polynomial b_;
+  void sequence_to_polynomial(const InputSequence &b, Polynomial &b_,
+                              std::false_type) const {
+    b_.clear();
     b_.reserve(n);
     std::transform(std::cbegin(b), std::cend(b), std::back_inserter(b_),
                    [](const auto &e) {
       return Element(static_cast<typename Element::storage_type>(e));
     });
-    return b_;
   }
 
-  static unsigned consecutive_zeroes(const Polynomial &g) {
-    auto zeroes =
-        math::gf::roots<extension_field>(g, math::gf::brute_force_tag{});
-    auto it = std::remove(std::begin(zeroes), std::end(zeroes), Element(0));
-    zeroes.erase(it, std::end(zeroes));
+protected:
+  /* Polynomials and elements from the constants of generator.h, given as
+   * storage values or, for binary polynomials, as bits. */
+  template <size_t Size>
+  static Polynomial to_polynomial(const detail::table<uint32_t, Size> &values,
+                                  const size_t size) {
+    Polynomial p;
+    p.reserve(size);
+    for (size_t i = 0; i < size; i++)
+      p.push_back(
+          Element(static_cast<typename Element::storage_type>(values[i]),
+                  math::gf::unchecked_tag{}));
+    return p;
+  }
 
-    std::vector<unsigned> powers;
-    powers.reserve(zeroes.size());
-    std::transform(std::cbegin(zeroes), std::cend(zeroes),
-                   std::back_inserter(powers),
-                   [](const auto &zero) { return zero.power(); });
-    std::sort(std::begin(powers), std::end(powers));
+  template <size_t Size>
+  static Polynomial to_polynomial(const detail::table<uint64_t, Size> &bits,
+                                  const size_t size) {
+    Polynomial p;
+    p.reserve(size);
+    for (size_t i = 0; i < size; i++)
+      p.push_back(Element(detail::bit(bits, i)));
+    return p;
+  }
 
-    auto first = std::find(std::cbegin(powers), std::cend(powers), 1);
-    auto last = std::adjacent_find(
-        first, std::cend(powers),
-        [](const auto &lhs, const auto &rhs) { return lhs + 1 != rhs; });
-    return static_cast<unsigned>(std::distance(first, last)) + 1;
+  template <size_t Size>
+  static Elements to_elements(const detail::table<uint32_t, Size> &values) {
+    Elements elements;
+    for (const auto &value : values)
+      elements.push_back(
+          Element(static_cast<typename Element::storage_type>(value),
+                  math::gf::unchecked_tag{}));
+    return elements;
   }
 
-protected:
-  template <typename Return_type = typename Element::storage_type,
-            typename InputSequence>
-  std::pair<Polynomial, size_t> correct_(const InputSequence &b,
-                                         const std::vector<unsigned> &erasures,
-                                         hard_decision_tag) const {
+  /* Number of consecutive zeroes α^1, α^2, ... of g, for the codes whose
+   * constants are computed at run time. Evaluating g at successive powers
+   * stops at the first non-zero, instead of searching the whole field. */
+  static unsigned consecutive_zeroes(const Polynomial &g_) {
+    constexpr unsigned order = (1u << q) - 1;
+    unsigned zeroes = 0;
+    while (zeroes + 1 < order && !g_(Element::from_power(zeroes + 1)))
+      zeroes++;
+    return std::max(zeroes, 1u);
+  }
+
+  /* Positions and values of the errors for a word with non-zero syndromes */
+  decode_status locate(const Elements &syndromes,
+                       const std::vector<unsigned> &erasures,
+                       Positions &positions, Elements &values) const {
+    const auto sigma =
+        error_locator_polynomial<Locator>(syndromes, erasures, Algorithm());
+    Elements zeroes_;
+    const auto status = zeroes(sigma, zeroes_);
+    if (!status)
+      return status;
+    positions = error_positions(zeroes_);
+    /* TODO: let this be a functor supplied by the derived class */
+    values = error_values(syndromes, sigma, zeroes_);
+    return status;
+  }
+
+  /* The corrected word is ws.word */
+  template <typename InputSequence>
+  decode_status correct_(const InputSequence &b,
+                         const std::vector<unsigned> &erasures, workspace &ws,
+                         hard_decision_tag) const {
     size_t errors = 0;
     if (b.size() != n) {
       std::ostringstream os;
@@ -217,22 +594,27 @@ protected:
       throw std::runtime_error(os.str());
     }
 
-    Polynomial b_(sequence_to_polynomial(
-        b,
-        typename std::is_signed<typename InputSequence::value_type>::type()));
+    if (erasures.size() > 2 * t)
+      return decode_status::failure(
+          "Number of erasures exceed error correction capability.");
+
+    Polynomial &b_ = ws.word;
+    sequence_to_polynomial(
+        b, b_,
+        typename std::is_signed<typename InputSequence::value_type>::type());
 
     /* add error correction */
-    auto syndromes = calculate_syndromes(b_, roots);
+    Elements syndromes;
+    calculate_syndromes(b_, roots, syndromes);
     bool error = std::any_of(std::begin(syndromes), std::end(syndromes),
                              [&](const auto &e) { return bool(e); });
 
     if (error) {
-      const auto sigma_ = error_locator_polynomial<Polynomial>(
-          syndromes, erasures, Algorithm());
-      const auto zeroes_ = zeroes(sigma_);
-      /* TODO: let this be a functor supplied by the derived class */
-      const auto positions = error_positions(zeroes_);
-      const auto values = error_values(syndromes, zeroes_);
+      Positions positions;
+      Elements values;
+      const auto status = locate(syndromes, erasures, positions, values);
+      if (!status)
+        return status;
 
       errors = positions.size();
       auto value = std::begin(values);
@@ -240,45 +622,80 @@ protected:
         b_.at(position) += *value++;
       }
 
-      syndromes = calculate_syndromes(b_, roots);
+      calculate_syndromes(b_, roots, syndromes);
 
       /* declare decoding failure - Avoid decoder malfunction */
       if (std::any_of(std::begin(syndromes), std::end(syndromes),
                       [&](const auto &e) { return bool(e); }))
-        throw decoding_failure("Corrected word is not a codeword");
+        return decode_status::failure("Corrected word is not a codeword");
     }
 
-    return std::make_pair(b_, errors);
+    return decode_status::corrected(errors);
   }
 
+  /* the errors are the flipped hard decisions */
   template <typename InputSequence>
-  std::pair<Polynomial, size_t> correct_(const InputSequence &b,
-                                         const std::vector<unsigned> &erasures,
-                                         soft_decision_tag) const {
-    using Result_type = typename Element::storage_type;
-    auto copy(b);
-
+  decode_status correct_(const InputSequence &b,
+                         const std::vector<unsigned> &erasures, workspace &ws,
+                         soft_decision_tag) const {
+    ws.soft.assign(std::cbegin(b), std::cend(b));
     for (const auto &erasure : erasures)
-      copy.at(erasure) = typename InputSequence::value_type(0);
+      ws.soft.at(erasure) = 0.0f;
 
-    std::vector<Result_type> result = std::get<0>(
-        min_sum<float, Result_type>(H<Result_type>(), copy, Algorithm{}));
-    return std::make_pair(Polynomial(result), -1);
+    const auto iteration = min_sum(
+        soft_checks ? *soft_checks : *parity_check(check_polynomial_tag{}),
+        ws.soft, ws.messages, Algorithm{});
+    if (iteration == Algorithm::iterations)
+      return decode_status::failure("Decoding failure");
+
+    size_t errors = 0;
+    ws.word.clear();
+    ws.word.reserve(n);
+    for (size_t i = 0; i < ws.messages.b.size(); i++) {
+      errors += (ws.messages.b[i] != 0) != (ws.soft[i] < 0);
+      ws.word.push_back(Element(ws.messages.b[i]));
+    }
+    return decode_status::corrected(errors);
   }
 
-public:
-  cyclic(Polynomial generator, std::vector<Element> roots_,
-         error_value_function error_values_)
-      : g(generator), h(f / g), roots(roots_),
+  /* throws decoding_failure */
+  template <typename Return_type = typename Element::storage_type,
+            typename InputSequence, typename Tag>
+  std::pair<Polynomial, size_t> correct_(const InputSequence &b,
+                                         const std::vector<unsigned> &erasures,
+                                         Tag tag) const {
+    workspace ws;
+    const size_t errors = correct_(b, erasures, ws, tag).value();
+    return std::make_pair(std::move(ws.word), errors);
+  }
+
+  /* Only the encoder of Encoding is built: G for generator_matrix_tag, the
+   * LFSR for division_tag. Codes with encoders of their own pass coding_tag
+   * for those they do not use. */
+  template <typename Encoding>
+  cyclic(Polynomial generator, Polynomial check, const Elements &roots_,
+         const unsigned designed_distance, error_value_function error_values_,
+         Encoding)
+      : g(std::move(generator)), h(std::move(check)), roots(roots_),
         k(static_cast<unsigned>(g.degree())), l(n - k),
-        dmin(consecutive_zeroes(g) + 1), rate(static_cast<double>(l) / n),
-        error_values(error_values_) {
+        dmin(designed_distance), rate(static_cast<double>(l) / n),
+        error_values(error_values_),
+        systematic(systematic_form(g, Encoding())),
+        shift_register(shift_register_form(g, Encoding())) {
     if (dmin > n) {
       std::cout << "dmin error: " << dmin << std::endl;
       throw std::runtime_error("dmin > n");
     }
   }
 
+public:
+  /* g, h = (x^n + 1) / g, the zeroes of g the syndromes are evaluated at and
+   * the designed distance are constants of the derived code. */
+  cyclic(Polynomial generator, Polynomial check, const Elements &roots_,
+         const unsigned designed_distance, error_value_function error_values_)
+      : cyclic(std::move(generator), std::move(check), roots_,
+               designed_distance, std::move(error_values_), Coding()) {}
+
   std::string to_string() const {
     std::ostringstream os;
     os << "(" << n << ", " << l << ", " << dmin << ")-"
@@ -300,14 +717,15 @@ public:
     std::transform(std::cbegin(a), std::cend(a), std::back_inserter(a_),
                    [](const auto &e) { return Element(e); });
 
-    auto enc = ::cyclic::encode(g, a_, Coding());
+    auto enc = ::cyclic::encode(coder(Coding()), a_, Coding());
 
     assert(enc.size() <= n);
 
-    std::transform(std::cbegin(enc), std::cend(enc), out, [](const Element &e) {
+    auto last = std::transform(std::cbegin(enc), std::cend(enc), out,
+                               [](const Element &e) {
       return typename InputSequence::value_type(e);
     });
-    std::fill_n(out, n - enc.size(), typename InputSequence::value_type(0));
+    std::fill_n(last, n - enc.size(), typename InputSequence::value_type(0));
   }
 
   template <typename InputSequence,
@@ -316,7 +734,8 @@ public:
                                   const std::vector<unsigned> &erasures =
                                       std::vector<unsigned>()) const {
     auto b_ =
-        ::cyclic::decode(g, correct_(b, erasures, Algorithm()).first, Coding());
+        ::cyclic::decode(decoder(Coding()),
+                         correct_(b, erasures, Algorithm()).first, Coding());
 
     std::vector<Return_type> r;
     r.reserve(l);
@@ -343,41 +762,76 @@ public:
     return r;
   }
 
-  template <typename T> matrix<T> H() const {
-    std::vector<T> row(n, T(0));
-    std::transform(std::crbegin(h), std::crend(h), std::begin(row),
-                   [](const Element &e) { return T(e); });
+  /* correct() into the n elements of out, with the buffers of ws. Decoding
+   * failures are returned instead of thrown; out is only written if decoding
+   * succeeds. */
+  template <typename InputSequence, typename Return_type>
+  decode_status
+  correct_into(const InputSequence &b, vector_view<Return_type> out,
+               workspace &ws, const std::vector<unsigned> &erasures =
+                                  std::vector<unsigned>()) const {
+    if (out.size() != n) {
+      std::ostringstream os;
+      os << "Output word has the wrong size (" << out.size() << "). Expected "
+         << n;
+      throw std::runtime_error(os.str());
+    }
 
-    matrix<T> control(row);
+    const auto status = correct_(b, erasures, ws, Algorithm());
+    if (!status)
+      return status;
+    auto last = std::transform(std::cbegin(ws.word), std::cend(ws.word),
+                               std::begin(out),
+                               [](const auto &e) { return Return_type(e); });
+    std::fill(last, std::end(out), Return_type(0));
+    return status;
+  }
 
-    std::generate_n(std::back_inserter(control), k - 1, [&]() {
-      std::rotate(std::rbegin(row), std::rbegin(row) + 1, std::rend(row));
-      return row;
-    });
+  /* H in the form Tag, built on first use */
+  const std::shared_ptr<const parity_checks> &
+  parity_check(check_polynomial_tag tag) const {
+    return parity_check(checks->polynomial_once, checks->polynomial, tag);
+  }
 
-    return control;
+  const std::shared_ptr<const parity_checks> &
+  parity_check(binary_roots_tag tag) const {
+    return parity_check(checks->roots_once, checks->roots, tag);
   }
 
-  template <typename T> matrix<T> H_alt() const {
-    matrix<Element> tmp(t, n);
+  /* Select the H soft decision decoding uses; check_polynomial_tag by
+   * default. Not synchronized: choose before sharing the code. */
+  template <typename Tag> void decode_with(Tag tag) {
+    soft_checks = parity_check(tag);
+  }
 
-    for (unsigned row = 0; row < t; row++) {
-      for (unsigned col = 0; col < n; col++) {
-        const unsigned row_power = 2 * row + 1;
-        tmp.at(row).at(col) = Element::from_power(col * row_power);
-      }
+  template <typename T> matrix<T> H() const {
+    /* row i is h reversed and cyclically shifted right by i */
+    matrix<T> control(k, n);
+    const size_t last = h.size() - 1;
+    for (size_t row = 0; row < k; row++) {
+      T *out = control[row].data();
+      for (size_t i = 0; i <= last; i++)
+        out[(row + i) % n] = T(h[last - i]);
     }
 
-    matrix<T> control(0, n);
+    return control;
+  }
 
-    for (const auto &row : tmp) {
-      for (size_t mask = 1, digits = Element::digits; digits;
-           mask <<= 1, digits--) {
-        std::vector<T> r;
-        r.reserve(n);
-        for (const auto &element : row)
-          r.push_back(bool(static_cast<size_t>(element) & mask));
-        control.push_back(r);
+  template <typename T> matrix<T> H_alt() const {
+    /* row row * digits + bit holds bit bit of α^(col (2 row + 1)) */
+    matrix<T> control(t * Element::digits, n);
+    std::vector<size_t> elements(n);
+
+    for (unsigned row = 0; row < t; row++) {
+      const unsigned row_power = 2 * row + 1;
+      for (unsigned col = 0; col < n; col++)
+        elements[col] =
+            static_cast<size_t>(Element::from_power(col * row_power));
+
+      for (size_t bit = 0; bit < Element::digits; bit++) {
+        T *out = control[row * Element::digits + bit].data();
+        for (unsigned col = 0; col < n; col++)
+          out[col] = T((elements[col] >> bit) & 1);
       }
     }
 
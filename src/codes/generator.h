@@ -0,0 +1,315 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "math/galois.h"
+
+/* Generator and check polynomials, zeroes and designed distance of BCH and RS
+ * codes as constant expressions of the code parameters. The codes only copy
+ * them into their polynomials on construction.
+ *
+ * Elements of GF(2^q) are their storage values for the default modular
+ * polynomial, with α = x. Beyond GF(2^16) the tables of the field are too
+ * large for constant expressions and the codes compute the same at run time. */
+namespace cyclic {
+namespace detail {
+
+constexpr unsigned max_constant_field = 16;
+
+/* true_type if the constants of codes over GF(2^q) are computed here */
+template <unsigned q>
+using constant_generator =
+    std::integral_constant<bool, (q <= max_constant_field)>;
+
+template <unsigned q> struct constant_field {
+  static_assert(q <= max_constant_field,
+                "Generator polynomials are computed at compile time for "
+                "fields up to GF(2^16) only.");
+
+  static constexpr uint64_t modular_polynomial =
+      math::detail::default_modular_polynomial<q>::type::value;
+  /* order of α */
+  static constexpr size_t order = (size_t(1) << q) - 1;
+
+  using exp_type = math::detail::table<uint32_t, 2 * order + 2>;
+  using log_type = math::detail::table<uint32_t, order + 1>;
+
+  static constexpr exp_type exp() {
+    return math::detail::exp_table<uint32_t, 2 * order + 2>(
+        q, modular_polynomial);
+  }
+  static constexpr log_type log() {
+    return math::detail::log_table<uint32_t, order + 1>(q, modular_polynomial);
+  }
+
+  /* a α^power */
+  static constexpr uint32_t multiply(const uint32_t a, const size_t power,
+                                     const exp_type &exp_,
+                                     const log_type &log_) {
+    return a ? exp_[(log_[a] + power % order) % order] : 0;
+  }
+};
+
+template <typename T, size_t N> using table = math::detail::table<T, N>;
+
+/* bits[shift, ...) ^= the first count words of other, for polynomials over
+ * GF(2) with 64 coefficients per word */
+template <size_t N, size_t M>
+constexpr void xor_shifted(table<uint64_t, N> &bits,
+                           const table<uint64_t, M> &other, const size_t count,
+                           const size_t shift) {
+  const size_t offset = shift / 64;
+  const size_t s = shift % 64;
+  for (size_t word = 0; word < count && word + offset < N; word++) {
+    bits[word + offset] ^= other[word] << s;
+    if (s && word + offset + 1 < N)
+      bits[word + offset + 1] ^= other[word] >> (64 - s);
+  }
+}
+
+template <size_t N> constexpr bool bit(const table<uint64_t, N> &bits,
+                                       const size_t i) {
+  return (bits[i / 64] >> (i % 64)) & 1;
+}
+
+template <size_t N> constexpr ssize_t degree(const table<uint64_t, N> &bits) {
+  for (size_t i = 64 * N; i--;) {
+    if (bit(bits, i))
+      return static_cast<ssize_t>(i);
+  }
+  return -1;
+}
+
+/* Number of consecutive zeroes α^1, α^2, ..., at least one */
+template <size_t N>
+constexpr unsigned consecutive_zeroes(const table<uint64_t, N> &zeroes,
+                                      const size_t order) {
+  unsigned count = 0;
+  while (count + 1 < order && bit(zeroes, count + 1))
+    count++;
+  return count ? count : 1;
+}
+
+/* The narrow-sense primitive BCH code of length N over GF(2^q) correcting t
+ * errors. Its zeroes are the cyclotomic cosets {i, 2i, 4i, ...} of the odd
+ * i < 2t and g is the product of their minimal polynomials. */
+template <unsigned q, unsigned t, unsigned N> struct bch_polynomials {
+  using field = constant_field<q>;
+  static constexpr size_t order = field::order;
+  static constexpr size_t words = order / 64 + 1;
+  static constexpr size_t check_words = N / 64 + 1;
+
+  /* bit i is the coefficient of x^i */
+  table<uint64_t, words> generator;
+  /* h = (x^N + 1) / g */
+  table<uint64_t, check_words> check;
+  /* m_i of α^i for i = 1, 3, ..., 2t - 1, conjugates included */
+  table<uint64_t, t> minimal;
+  /* α^1, ..., α^(2t) */
+  table<uint32_t, 2 * t> roots;
+  /* bit i is set if α^i is a zero of g */
+  table<uint64_t, words> zeroes;
+  /* degree of g */
+  size_t k;
+  unsigned designed_distance;
+
+  static constexpr bch_polynomials compute() {
+    const auto exp = field::exp();
+    const auto log = field::log();
+    bch_polynomials p{};
+
+    p.generator[0] = 1;
+    for (unsigned i = 1; i < 2 * t; i += 2) {
+      /* m_i = (x + α^i)(x + α^(2i))(x + α^(4i)) ... */
+      uint32_t m[q + 1] = {};
+      m[0] = 1;
+      size_t degree_ = 0;
+      size_t power = i % order;
+      do {
+        degree_++;
+        for (size_t j = degree_; j; j--)
+          m[j] = m[j - 1] ^ field::multiply(m[j], power, exp, log);
+        m[0] = field::multiply(m[0], power, exp, log);
+        power = 2 * power % order;
+      } while (power != i % order && degree_ < q);
+
+      for (size_t j = 0; j <= degree_; j++)
+        p.minimal[i / 2] |= uint64_t(m[j] & 1) << j;
+
+      /* α^i is already a zero of g, if it is conjugate to an earlier power */
+      if (bit(p.zeroes, i % order))
+        continue;
+      do {
+        p.zeroes[power / 64] |= uint64_t(1) << (power % 64);
+        power = 2 * power % order;
+      } while (power != i % order);
+
+      const size_t count = static_cast<size_t>(degree(p.generator)) / 64 + 1;
+      table<uint64_t, words> product{};
+      for (size_t j = 0; j <= degree_; j++) {
+        if ((p.minimal[i / 2] >> j) & 1)
+          xor_shifted(product, p.generator, count, j);
+      }
+      p.generator = product;
+    }
+
+    /* long division, one coefficient at a time */
+    const size_t k = p.k = static_cast<size_t>(degree(p.generator));
+    const size_t count = k / 64 + 1;
+    table<uint64_t, check_words> remainder{};
+    remainder[0] = 1;
+    remainder[N / 64] |= uint64_t(1) << (N % 64);
+    for (size_t i = N + 1; i-- > k;) {
+      if (bit(remainder, i)) {
+        p.check[(i - k) / 64] |= uint64_t(1) << ((i - k) % 64);
+        xor_shifted(remainder, p.generator, count, i - k);
+      }
+    }
+
+    for (size_t i = 0; i < 2 * t; i++)
+      p.roots[i] = exp[(i + 1) % order];
+    p.designed_distance = consecutive_zeroes(p.zeroes, order) + 1;
+    return p;
+  }
+};
+
+template <unsigned q, unsigned t, unsigned N> struct bch_constants {
+  static constexpr bch_polynomials<q, t, N> value =
+      bch_polynomials<q, t, N>::compute();
+};
+
+template <unsigned q, unsigned t, unsigned N>
+constexpr bch_polynomials<q, t, N> bch_constants<q, t, N>::value;
+
+/* Row 256 i + y of the remainder table of the slicing-by-8 encoder is
+ * y x^(k + 8 i) mod g, in words words. The rows of the bits are x^(k + j) mod
+ * g, each x times the previous one reduced by g, and the others their sums. */
+template <unsigned q, unsigned t, unsigned N> struct bch_remainders {
+  static constexpr size_t k = bch_constants<q, t, N>::value.k;
+  static constexpr size_t words = (k + 63) / 64;
+  static constexpr size_t rows = 8 * 256;
+
+  table<uint64_t, rows * words> values;
+
+  constexpr const uint64_t *operator[](const size_t row) const {
+    return values.begin() + row * words;
+  }
+
+  static constexpr bch_remainders compute() {
+    const auto &g = bch_constants<q, t, N>::value.generator;
+    const uint64_t top =
+        k % 64 ? (uint64_t(1) << (k % 64)) - 1 : ~uint64_t(0);
+    bch_remainders r{};
+
+    /* x^k mod g = g + x^k */
+    for (size_t word = 0; word < words; word++)
+      r.values[words + word] = g[word];
+    r.values[2 * words - 1] &= top;
+
+    for (size_t j = 1; j < 64; j++) {
+      const size_t previous =
+          words * (256 * ((j - 1) / 8) + (size_t(1) << ((j - 1) % 8)));
+      const size_t row = words * (256 * (j / 8) + (size_t(1) << (j % 8)));
+      const bool carry =
+          (r.values[previous + (k - 1) / 64] >> ((k - 1) % 64)) & 1;
+      r.values[row] = r.values[previous] << 1;
+      for (size_t word = 1; word < words; word++)
+        r.values[row + word] = (r.values[previous + word] << 1) |
+                               (r.values[previous + word - 1] >> 63);
+      r.values[row + words - 1] &= top;
+      if (carry) {
+        for (size_t word = 0; word < words; word++)
+          r.values[row + word] ^= r.values[words + word];
+      }
+    }
+
+    for (size_t byte = 0; byte < 8; byte++) {
+      for (size_t y = 3; y < 256; y++) {
+        const size_t low = y & (0 - y);
+        if (y == low)
+          continue;
+        const size_t entry = words * (256 * byte + y);
+        const size_t previous = words * (256 * byte + (y ^ low));
+        const size_t row = words * (256 * byte + low);
+        for (size_t word = 0; word < words; word++)
+          r.values[entry + word] =
+              r.values[previous + word] ^ r.values[row + word];
+      }
+    }
+    return r;
+  }
+};
+
+template <unsigned q, unsigned t, unsigned N> struct bch_remainder_table {
+  static constexpr bch_remainders<q, t, N> value =
+      bch_remainders<q, t, N>::compute();
+};
+
+template <unsigned q, unsigned t, unsigned N>
+constexpr bch_remainders<q, t, N> bch_remainder_table<q, t, N>::value;
+
+/* The RS code of length N over GF(2^q) with the zeroes α^(mu + i step),
+ * i < 2t; g is the product of x + α^(mu + i step). */
+template <unsigned q, unsigned t, unsigned N, unsigned mu, unsigned step>
+struct rs_polynomials {
+  using field = constant_field<q>;
+  static constexpr size_t order = field::order;
+  static constexpr size_t words = order / 64 + 1;
+
+  /* coefficient i is the coefficient of x^i */
+  table<uint32_t, 2 * t + 1> generator;
+  /* h = (x^N + 1) / g */
+  table<uint32_t, N + 1> check;
+  table<uint32_t, 2 * t> roots;
+  unsigned designed_distance;
+
+  static constexpr rs_polynomials compute() {
+    const auto exp = field::exp();
+    const auto log = field::log();
+    rs_polynomials p{};
+    table<uint64_t, words> zeroes{};
+
+    p.generator[0] = 1;
+    for (size_t i = 0; i < 2 * t; i++) {
+      const size_t power = (mu + i * step) % order;
+      p.roots[i] = exp[power];
+      zeroes[power / 64] |= uint64_t(1) << (power % 64);
+      for (size_t j = i + 1; j; j--)
+        p.generator[j] = p.generator[j - 1] ^
+                         field::multiply(p.generator[j], power, exp, log);
+      p.generator[0] = field::multiply(p.generator[0], power, exp, log);
+    }
+
+    /* g is monic, so the quotient coefficient is the leading remainder */
+    table<uint32_t, N + 1> remainder{};
+    remainder[0] = 1;
+    remainder[N] ^= 1;
+    for (size_t i = N + 1; i-- > 2 * t;) {
+      const uint32_t c = remainder[i];
+      if (!c)
+        continue;
+      p.check[i - 2 * t] = c;
+      const size_t power = log[c];
+      for (size_t j = 0; j <= 2 * t; j++)
+        remainder[i - 2 * t + j] ^=
+            field::multiply(p.generator[j], power, exp, log);
+    }
+
+    p.designed_distance = consecutive_zeroes(zeroes, order) + 1;
+    return p;
+  }
+};
+
+template <unsigned q, unsigned t, unsigned N, unsigned mu, unsigned step>
+struct rs_constants {
+  static constexpr rs_polynomials<q, t, N, mu, step> value =
+      rs_polynomials<q, t, N, mu, step>::compute();
+};
+
+template <unsigned q, unsigned t, unsigned N, unsigned mu, unsigned step>
+constexpr rs_polynomials<q, t, N, mu, step>
+    rs_constants<q, t, N, mu, step>::value;
+}
+}
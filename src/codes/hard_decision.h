@@ -5,9 +5,14 @@
 #include <iterator>
 #include <numeric>
 #include <string>
+#include <algorithm>
+#include <utility>
 
 #include "codes/codes.h"
-#include "math/linear_equation_system.h"
+#include "math/gaussian_elimination.h"
+#include "math/kernels.h"
+#include "math/polynomial.h"
+#include "math/static_vector.h"
 #include "protocol.h"
 
 namespace cyclic {
@@ -22,6 +27,17 @@ struct berlekamp_massey_tag : hard_decision_tag {
 struct euklid_tag : hard_decision_tag {
   static std::string to_string() { return "EUKLID"; }
 };
+/* Berlekamp's simplification for binary codes: every other discrepancy is
+ * zero, so only t iterations are needed. */
+struct simplified_berlekamp_massey_tag : hard_decision_tag {
+  static std::string to_string() { return "SBM"; }
+};
+/* D. V. Sarwate, N. R. Shanbhag, High-speed architectures for Reed-Solomon
+ *                                decoders, IEEE Transactions on VLSI Systems,
+ *                                vol.9, no.5, pp.641-655, 2001. */
+struct reformulated_inversionless_berlekamp_massey_tag : hard_decision_tag {
+  static std::string to_string() { return "RIBM"; }
+};
 /* TODO:
  * L. R. Welch, E. Berlekamp, Error correction for algebraic block codes, US
  *                            Patent, Number 4,633,470, 1986.
@@ -30,92 +46,154 @@ struct euklid_tag : hard_decision_tag {
  * J. Jiang, K. R. Narayanan, Iterative Soft Decoding of Reed-Solomon Codes,
  *                            IEEE Communications Letters, vol.8, no.4,
  *                            pp.244-246, 2004.
- * inverse-free BMAs
  */
 
-#if 0
-std::vector<gf_element> chien(const gf &field, gf_polynomial polynomial) {
-  std::vector<gf_element> zeroes;
-  std::vector<gf_element> factors(polynomial.size(), field.zero());
-  std::iota(std::begin(factors), std::end(factors), field.one());
-
-  for (int i = 0; i < field.size(); i++) {
-    auto result = std::accumulate(std::begin(polynomial), std::end(polynomial),
-                                  field.zero());
-    if (result == field.zero()) {
-      zeroes.push_back(field.power_to_polynomial(i));
-    }
+namespace detail {
+/* The t x (t + 1) PGZ syndrome matrix */
+template <typename Syndromes> struct pgz_storage {
+  using type = std::vector<typename Syndromes::value_type>;
+};
 
-    /* multiply by alpha, alpha^2, ... */
-    std::transform(
-        std::cbegin(polynomial), std::cend(polynomial), std::cbegin(factors),
-        std::begin(polynomial),
-        [](const gf_element &lhs, const gf_element &rhs) { return lhs * rhs; });
-  }
+template <typename Element, size_t Capacity>
+struct pgz_storage<math::static_vector<Element, Capacity> > {
+  using type = math::static_vector<Element, Capacity / 2 * (Capacity / 2 + 1)>;
+};
+}
 
-  return zeroes;
+namespace detail {
+/* Error locators with at most this many errors are solved in closed form */
+static constexpr size_t pgz_closed_form_errors = 3;
+
+template <typename Element>
+Element determinant(const Element &a, const Element &b, const Element &c,
+                    const Element &d) {
+  return a * d - b * c;
 }
-#endif
 
+template <typename Element>
+Element determinant(const Element &a, const Element &b, const Element &c,
+                    const Element &d, const Element &e, const Element &f,
+                    const Element &g, const Element &h, const Element &i) {
+  return a * determinant(e, f, h, i) - b * determinant(d, f, g, i) +
+         c * determinant(d, e, g, h);
+}
+
+/* The solution of the PGZ equations for v errors by Cramer's rule, if the
+ * v x v syndrome matrix is regular. */
+template <typename Polynomial, typename Syndromes>
+bool pgz_closed_form(const Syndromes &S, const size_t v, Polynomial &sigma) {
+  using Element = typename Polynomial::coefficient_type;
+  switch (v) {
+  case 1: {
+    if (!S[0])
+      return false;
+    sigma = Polynomial({ S[1] / S[0], Element(1) });
+    return true;
+  }
+  case 2: {
+    const Element det = determinant(S[0], S[1], S[1], S[2]);
+    if (!det)
+      return false;
+    const Element inverse = det.inverse();
+    sigma = Polynomial({ determinant(S[2], S[1], S[3], S[2]) * inverse,
+                         determinant(S[0], S[2], S[1], S[3]) * inverse,
+                         Element(1) });
+    return true;
+  }
+  case 3: {
+    const Element det = determinant(S[0], S[1], S[2], S[1], S[2], S[3], S[2],
+                                    S[3], S[4]);
+    if (!det)
+      return false;
+    const Element inverse = det.inverse();
+    sigma = Polynomial(
+        { determinant(S[3], S[1], S[2], S[4], S[2], S[3], S[5], S[3], S[4]) *
+              inverse,
+          determinant(S[0], S[3], S[2], S[1], S[4], S[3], S[2], S[5], S[4]) *
+              inverse,
+          determinant(S[0], S[1], S[3], S[1], S[2], S[4], S[2], S[3], S[5]) *
+              inverse,
+          Element(1) });
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+/* Gauss-Jordan elimination of the t x (t + 1) syndrome matrix column by
+ * column. With v <= t errors its first v columns are linearly independent and
+ * column v is their combination with the coefficients of the error locator,
+ * so the first column without pivot gives both v and σ(x). */
+template <typename Polynomial, typename Syndromes>
+Polynomial pgz_elimination(const Syndromes &syndromes) {
+  using Element = typename Polynomial::coefficient_type;
+  const size_t fk = syndromes.size() / 2;
+
+  math::dense_system<Element, typename pgz_storage<Syndromes>::type> system(
+      fk, fk + 1);
+  for (size_t i = 0; i < fk; i++)
+    std::copy(std::cbegin(syndromes) + static_cast<ssize_t>(i),
+              std::cbegin(syndromes) + static_cast<ssize_t>(i + fk + 1),
+              system[i]);
 
-template <typename Polynomial,
+  /* in reduced row echelon form, the pivot of row j is in column j for all
+   * j < v */
+  const size_t rank = system.eliminate();
+  size_t v = 0;
+  while (v < rank && system.pivot(v) == v)
+    v++;
+
+  if (v == 0)
+    return Polynomial();
+
+  Polynomial sigma;
+  for (size_t j = 0; j < v; j++)
+    sigma.push_back(system[j][v]);
+  sigma.push_back(Element(1));
+  return sigma;
+}
+}
+
+/* The number of errors v is the rank of the t x t syndrome matrix and the v x v
+ * leading submatrix is regular, so σ(x) solves
+ *
+ *   | S_0      ...  S_(v-1)  |   | σ_0     |   | S_v      |
+ *   | ...           ...      | * | ...     | = | ...      |
+ *   | S_(v-1)  ...  S_(2v-2) |   | σ_(v-1) |   | S_(2v-1) |
+ *
+ * Up to three errors, the largest regular leading submatrix is found by its
+ * determinant and σ(x) follows from Cramer's rule. Otherwise one elimination
+ * of the whole matrix determines v and σ(x).
+ *
+ * All error_locator_polynomial() overloads report a decoding failure without
+ * an exception, by the zero polynomial without coefficients (degree -1).
+ */
+template <typename Polynomial, typename Syndromes,
           typename Element = typename Polynomial::coefficient_type>
-Polynomial error_locator_polynomial(const std::vector<Element> &syndromes,
+Polynomial error_locator_polynomial(const Syndromes &syndromes,
                                     const std::vector<unsigned> &erasures,
                                     peterson_gorenstein_zierler_tag) {
   if (!erasures.empty())
     throw std::runtime_error(
         "The PGZ-Algorithm does not support erasure decoding");
 
-  /* TODO: this implementation suffers from decoder malfunction. Fix it.
-   * http://ieeexplore.ieee.org/stamp/stamp.jsp?tp=&arnumber=333881
-   */
-  for (ssize_t v = static_cast<ssize_t>(syndromes.size() / 2); v; --v) {
-    math::linear_equation_system<Polynomial> eq_system;
-    for (auto it = std::cbegin(syndromes); it != std::cbegin(syndromes) + v;
-         ++it) {
-      Polynomial poly;
-      std::reverse_copy(it, it + v + 1, std::back_inserter(poly));
-      eq_system.push_back(poly);
-    }
+  const size_t fk = syndromes.size() / 2;
+  if (fk > detail::pgz_closed_form_errors)
+    return detail::pgz_elimination<Polynomial>(syndromes);
 
-    // TODO Check if the determinant is non-zero.
-    try {
-      auto solution = eq_system.solution();
-      solution.push_back(Element(1));
-      return solution;
-    }
-    catch (const std::exception &) {
-    }
+  Polynomial sigma;
+  for (size_t v = fk; v; v--) {
+    if (detail::pgz_closed_form(syndromes, v, sigma))
+      return sigma;
   }
-
-  /* note: this was supposed to solve decoder malfunction, but it is bullshit.
-   * if v < t, then multiple equation systems can be built. each must be
-   * solvable and yield the same result. otherwise, decoding failure must be
-   * declared.
-   * This is not an immediate problem anymore, since the corrected codeword's
-   * syndrome is checked again.
-   */
-  auto sigma = syndromes.front();
-  std::cout << sigma << std::endl;
-  for (auto it = std::begin(syndromes); it != std::end(syndromes) - 1; ++it) {
-    if (*it == Element(0))
-      throw decoding_failure("Cannot invert syndrome, it is 0.");
-    std::cout << *it << " " << Element(1) / *it << std::endl;
-    auto sigma_ = *(it + 1) * (Element(1) / *it);
-    std::cout << *(it + 1) << " " << sigma_ << std::endl;
-    if (sigma != sigma_) {
-      // std::cout << sigma << " " << sigma_ << std::endl;
-      throw decoding_failure("No solution found.");
-    }
-  }
-
-  return Polynomial({ sigma, Element(1) });
+  /* the syndrome matrix is zero */
+  return Polynomial();
 }
 
-template <typename Polynomial,
+template <typename Polynomial, typename Syndromes,
           typename Element = typename Polynomial::coefficient_type>
-Polynomial error_locator_polynomial(const std::vector<Element> &syndromes,
+Polynomial error_locator_polynomial(const Syndromes &syndromes,
                                     const std::vector<unsigned> &erasures,
                                     berlekamp_massey_tag) {
   const auto fk = syndromes.size() / 2;
@@ -134,7 +212,7 @@ Polynomial error_locator_polynomial(const std::vector<Element> &syndromes,
     /* b = b * x; */
     b *= Polynomial({ Element(0), Element(1) });
     /* d = si + \sigma_j=1^l lambda_j * s_i-j; */
-    ssize_t end_offset = static_cast<ssize_t>(l + 1);
+    ssize_t end_offset = static_cast<ssize_t>(std::min(l + 1, lambda.size()));
     ssize_t start_offset = static_cast<ssize_t>(i);
     const auto delta = std::inner_product(
         std::cbegin(lambda) + 1, std::cbegin(lambda) + end_offset,
@@ -154,9 +232,180 @@ Polynomial error_locator_polynomial(const std::vector<Element> &syndromes,
   return lambda.reverse();
 }
 
-template <typename Polynomial,
+template <typename Polynomial, typename Syndromes,
           typename Element = typename Polynomial::coefficient_type>
-Polynomial error_locator_polynomial(const std::vector<Element> &syndromes,
+Polynomial error_locator_polynomial(const Syndromes &syndromes,
+                                    const std::vector<unsigned> &erasures,
+                                    simplified_berlekamp_massey_tag) {
+  /* the odd discrepancies only vanish for Λ(x) = 1 initially */
+  if (!erasures.empty())
+    return error_locator_polynomial<Polynomial>(syndromes, erasures,
+                                                berlekamp_massey_tag());
+
+  const auto fk = syndromes.size() / 2;
+  const size_t size = 2 * fk + 2;
+  Polynomial buffers[3] = { Polynomial(size, Element(0)),
+                            Polynomial(size, Element(0)),
+                            Polynomial(size, Element(0)) };
+  Element *lambda = buffers[0].data();
+  Element *b = buffers[1].data();
+  Element *previous = buffers[2].data();
+  lambda[0] = Element(1);
+  b[0] = Element(1);
+
+  /* b(x) is kept as x^shift b(x), so multiplying it by x does not move it */
+  size_t l = 0;
+  size_t shift = 1;
+  size_t b_size = 1;
+  for (size_t i = 0; i < 2 * fk; i += 2, shift += 2) {
+    Element delta(0);
+    for (size_t j = 0; j <= std::min(l, i); j++)
+      delta = delta + lambda[j] * syndromes[i - j];
+
+    if (!delta)
+      continue;
+
+    const size_t span = std::min(b_size, size - shift);
+    if (2 * l <= i) {
+      std::copy(lambda, lambda + l + 1, previous);
+      math::kernel::axpy(lambda + shift, lambda + shift + span, b, delta);
+      math::kernel::scale(previous, previous + l + 1, delta.inverse());
+      std::swap(b, previous);
+      b_size = l + 1;
+      shift = 0;
+      l = i + 1 - l;
+    } else {
+      math::kernel::axpy(lambda + shift, lambda + shift + span, b, delta);
+    }
+  }
+
+  Polynomial result(lambda, lambda + l + 1);
+  return result.reverse();
+}
+
+/* riBM: the discrepancies are not computed by inner products, but are the
+ * lowest coefficients of Λ(x) S(x), which is updated along with Λ(x) in one
+ * array of 3t + 1 coefficients. No element is inverted, so Λ(x) is only known
+ * up to a factor. */
+template <typename Polynomial, typename Syndromes,
+          typename Element = typename Polynomial::coefficient_type>
+Polynomial
+error_locator_polynomial(const Syndromes &syndromes,
+                         const std::vector<unsigned> &erasures,
+                         reformulated_inversionless_berlekamp_massey_tag) {
+  if (!erasures.empty())
+    return error_locator_polynomial<Polynomial>(syndromes, erasures,
+                                                berlekamp_massey_tag());
+
+  const auto fk = syndromes.size() / 2;
+  const size_t size = 3 * fk + 1;
+  Polynomial delta_(size, Element(0));
+  Polynomial theta_(size, Element(0));
+  Element *delta = delta_.data();
+  Element *theta = theta_.data();
+  std::copy(std::cbegin(syndromes), std::cbegin(syndromes) + 2 * fk, delta);
+  std::copy(std::cbegin(syndromes), std::cbegin(syndromes) + 2 * fk, theta);
+  delta[size - 1] = Element(1);
+  theta[size - 1] = Element(1);
+
+  /* δ(r + 1) = γ δ(r) / x - δ_0 θ(r) and, if δ_0 is the new γ, θ(r + 1) =
+   * δ(r) / x. In ascending order, δ_(i+1)(r) is read before it is replaced. */
+  Element gamma(1);
+  ssize_t k = 0;
+  for (size_t r = 0; r < 2 * fk; r++) {
+    const Element delta0 = delta[0];
+    const Element minus_delta0 = Element(0) - delta0;
+    if (delta0 && k >= 0) {
+      for (size_t i = 0; i < size; i++) {
+        const Element next = i + 1 < size ? delta[i + 1] : Element(0);
+        delta[i] = gamma * next + minus_delta0 * theta[i];
+        theta[i] = next;
+      }
+      gamma = delta0;
+      k = -k - 1;
+    } else {
+      for (size_t i = 0; i < size; i++) {
+        const Element next = i + 1 < size ? delta[i + 1] : Element(0);
+        delta[i] = gamma * next + minus_delta0 * theta[i];
+      }
+      k++;
+    }
+  }
+
+  /* Λ(x) = δ_t + δ_(t+1) x + ... */
+  /* Λ(0) is zero */
+  if (delta[fk] == Element(0))
+    return Polynomial();
+  Polynomial result(delta + fk, delta + 2 * fk + 1);
+  return result.reverse();
+}
+
+namespace detail {
+/* r_prev = r_prev mod r in place. Every term c x^shift of -(r_prev div r) is
+ * passed to apply as soon as it is known, so the quotient is never stored. */
+template <typename Polynomial, typename Apply>
+void reduce(Polynomial &r_prev, const Polynomial &r, Apply &&apply) {
+  using Element = typename Polynomial::coefficient_type;
+  const ssize_t dr = r.degree();
+  const Element inverse = Element(1) / r.at(static_cast<size_t>(dr));
+  for (ssize_t i = r_prev.degree(); i >= dr; i--) {
+    const size_t shift = static_cast<size_t>(i - dr);
+    const Element c = Element(0) - r_prev.at(static_cast<size_t>(i)) * inverse;
+    if (!c)
+      continue;
+    math::kernel::axpy(r_prev.data() + shift,
+                       r_prev.data() + shift + static_cast<size_t>(dr) + 1,
+                       r.data(), c);
+    apply(shift, c);
+  }
+}
+
+/* w_prev has room for w_prev + x^shift w for all shift <= max_shift */
+template <typename Polynomial>
+void reserve(Polynomial &w_prev, const Polynomial &w, const ssize_t max_shift) {
+  using Element = typename Polynomial::coefficient_type;
+  const ssize_t degree = w.degree();
+  if (max_shift < 0 || degree < 0)
+    return;
+  const auto size = static_cast<size_t>(max_shift + degree) + 1;
+  while (w_prev.size() < size)
+    w_prev.push_back(Element(0));
+}
+
+/* w_prev += c x^shift w */
+template <typename Polynomial, typename Element>
+void add_shifted(Polynomial &w_prev, const Polynomial &w, const size_t shift,
+                 const Element &c) {
+  const ssize_t degree = w.degree();
+  if (degree >= 0)
+    math::kernel::axpy(w_prev.data() + shift,
+                       w_prev.data() + shift + static_cast<size_t>(degree) + 1,
+                       w.data(), c);
+}
+
+/* r_prev = r_prev mod r and w_prev = w_prev - (r_prev div r) w in one pass */
+template <typename Polynomial>
+void euclid_step(Polynomial &r_prev, const Polynomial &r, Polynomial &w_prev,
+                 const Polynomial &w) {
+  reserve(w_prev, w, r_prev.degree() - r.degree());
+  reduce(r_prev, r, [&](const size_t shift, const auto &c) {
+    add_shifted(w_prev, w, shift, c);
+  });
+}
+}
+
+/* Sugiyama's algorithm: the remainder sequence of x^(2t) and S(x) is followed
+ * until the degree drops below t.
+ *
+ * Only the last two remainders and cofactors are kept and updated in place, so
+ * the polynomials can live on the stack. A half-gcd recursion needs
+ * O(M(t) log t) operations for the cost M(t) of a product of degree t, but
+ * with schoolbook products it does about four times the work of this loop:
+ * for GF(2^20) it was still 15% slower at 2^17 syndromes, more than any code
+ * here has. */
+template <typename Polynomial, typename Syndromes,
+          typename Element = typename Polynomial::coefficient_type>
+Polynomial error_locator_polynomial(const Syndromes &syndromes,
                                     const std::vector<unsigned> &erasures,
                                     euklid_tag) {
   const auto fk = syndromes.size() / 2;
@@ -164,34 +413,37 @@ Polynomial error_locator_polynomial(const std::vector<Element> &syndromes,
   const auto max = static_cast<ssize_t>((2 * fk + erasures.size()) / 2);
 
   Polynomial u({ Element(1) });
-  std::vector<Polynomial> w;
-  std::vector<Polynomial> r;
-  Polynomial s(syndromes);
-
   for (const auto &erasure : erasures)
     u *= Polynomial({ Element(1), Element::from_power(erasure) });
 
-  r.push_back(s * u);
-  r.push_back(Polynomial(dmin - 1, Element(0)));
-  r.back().push_back(Element(1));
+  /* x^(2t) and S(x) u(x) mod x^(2t) with the cofactors 0 and u(x) */
+  Polynomial r_prev(dmin - 1, Element(0));
+  r_prev.push_back(Element(1));
+  Polynomial r(Polynomial(std::cbegin(syndromes), std::cend(syndromes)) * u);
+  r = Polynomial(std::cbegin(r),
+                 std::cbegin(r) + static_cast<ssize_t>(std::min(
+                                      r.size(), dmin - 1)));
 
-  w.push_back(u);
-  w.push_back(Polynomial({ Element(0) }));
+  Polynomial w_prev({ Element(0) });
+  Polynomial w(u);
 
-  for (size_t i = 1; r.back().degree() >= max; i++) {
-    auto next = r.at(i - 1) % r.at(i);
-    auto q = r.at(i - 1) / r.at(i);
-    w.push_back(w.at(i - 1) + q * w.at(i));
-    r.push_back(next);
+  Polynomial *a = &r_prev;
+  Polynomial *b = &r;
+  Polynomial *w_a = &w_prev;
+  Polynomial *w_b = &w;
+  while (b->degree() >= max) {
+    detail::euclid_step(*a, *b, *w_a, *w_b);
+    std::swap(a, b);
+    std::swap(w_a, w_b);
   }
+  if (w_b != &w)
+    w = *w_b;
 
-  /* I wish I had static_if ... */
-  protocol_euklid(r, w, std::false_type());
-
-  if (w.back().at(0) == Element(0))
-    throw decoding_failure("Cannot invert last element");
+  /* w(0) cannot be inverted */
+  if (w.at(0) == Element(0))
+    return Polynomial();
 
-  auto lambda = w.back() * w.back().at(0).inverse();
+  auto lambda = w * w.at(0).inverse();
   return lambda.reverse();
 }
 }
@@ -1,65 +1,90 @@
 #pragma once
 
 #include "codes/cyclic.h"
+#include "math/linear_equation_system.h"
 
 namespace cyclic {
 template <unsigned q, typename Capability,
           typename Sigma = peterson_gorenstein_zierler_tag,
           unsigned N = (1 << q) - 1, typename Coding = division_tag,
-          unsigned mu = 1, unsigned step = 1>
-class rs : public cyclic<q, Capability, Sigma, N, Coding, naive_tag> {
-  using Base = cyclic<q, Capability, Sigma, N, Coding, naive_tag>;
+          unsigned mu = 1, unsigned step = 1, typename Error = forney_tag>
+class rs : public cyclic<q, Capability, Sigma, N, Coding, Error> {
+  using Base = cyclic<q, Capability, Sigma, N, Coding, Error>;
+
+  static_assert(!std::is_same<Sigma, simplified_berlekamp_massey_tag>::value,
+                "The simplified Berlekamp-Massey algorithm needs binary "
+                "codes.");
 
 public:
   using Element = typename Base::Element;
   using Polynomial = typename Base::Polynomial;
+  using Locator = typename Base::Locator;
+  using Elements = typename Base::Elements;
 
 private:
-  static Polynomial g() {
-    Polynomial g({ Element(1) });
+  using constants = detail::rs_constants<q, Base::t, N, mu, step>;
+  using compile_time = detail::constant_generator<q>;
 
-    for (unsigned i = 0; i < 2 * Base::t; ++i) {
-      auto power = mu + i * step;
-      Element root = Element::from_power(power);
-      g *= Polynomial({ root, Element(1) });
-    }
+  static Polynomial g(std::true_type) {
+    return Base::to_polynomial(constants::value.generator, 2 * Base::t + 1);
+  }
 
-    return g;
+  /* Beyond the fields of generator.h, g is the product of x + α^(mu + i step)
+   * for i < 2t. */
+  static Polynomial g(std::false_type) {
+    Polynomial g_({ Element(1) });
+    for (const auto &root : syndrome_roots(std::false_type()))
+      g_ *= Polynomial({ root, Element(1) });
+    return g_;
   }
 
-  static std::vector<Element> syndromes() {
-    std::vector<Element> syndromes;
+  static Polynomial h(const Polynomial &, std::true_type) {
+    return Base::to_polynomial(constants::value.check, N - 2 * Base::t + 1);
+  }
 
-    for (unsigned i = 0; i < 2 * Base::t; ++i) {
-      auto power = mu + i * step;
-      Element root = Element::from_power(power);
-      syndromes.push_back(root);
-    }
-    return syndromes;
+  static Polynomial h(const Polynomial &g_, std::false_type) {
+    return Base::f / g_;
+  }
+
+  static Elements syndrome_roots(std::true_type) {
+    return Base::to_elements(constants::value.roots);
+  }
+
+  static Elements syndrome_roots(std::false_type) {
+    Elements roots_;
+    for (unsigned i = 0; i < 2 * Base::t; i++)
+      roots_.push_back(Element::from_power(mu + i * step));
+    return roots_;
   }
 
-  static std::vector<Element>
-  error_values(const std::vector<Element> &syndromes,
-               const std::vector<Element> &zeroes) {
-    /* Let s_j be the syndrome values.
-     * Let x_i be the error positions.
-     * Let y_i be the error values.
-     *
-     * To find the y_i's solve the linear equation system:
-     *
-     * s_j = Σ_{i=1}^{v} y_i * x_i^j
-     */
-
-    std::cout << std::endl << "Calculating error values naively" << std::endl;
+  static unsigned designed_distance(const Polynomial &, std::true_type) {
+    return constants::value.designed_distance;
+  }
+
+  static unsigned designed_distance(const Polynomial &g_, std::false_type) {
+    return Base::consecutive_zeroes(g_) + 1;
+  }
+
+  /* Let s_j be the syndrome values.
+   * Let x_i be the error positions.
+   * Let y_i be the error values.
+   *
+   * To find the y_i's solve the linear equation system:
+   *
+   * s_j = Σ_{i=1}^{v} y_i * x_i^j
+   */
+  static Elements error_values(const Elements &syndromes, const Locator &,
+                               const Elements &zeroes, naive_tag) {
     const size_t v = zeroes.size();
-    const Polynomial factor(
-        std::vector<Element>(std::rbegin(zeroes), std::rend(zeroes)));
+    const Locator factor(std::crbegin(zeroes), std::crend(zeroes));
 
-    Polynomial row(factor);
-    math::linear_equation_system<Polynomial> system;
+    Locator row(factor);
+    math::linear_equation_system<Locator,
+                                 math::static_vector<Locator, 2 * Base::t> >
+        system;
 
     for (size_t i = 0; i < v; i++) {
-      Polynomial tmp({ syndromes.at(i) });
+      Locator tmp({ syndromes.at(i) });
       std::copy(std::cbegin(row), std::cend(row), std::back_inserter(tmp));
       system.push_back(tmp);
       // row *= factor; element wise mult.
@@ -68,23 +93,64 @@ private:
           [](const Element &lhs, const Element &rhs) { return rhs * lhs; });
     }
 
-    std::cout << system << std::endl;
-
-    std::cout << "Solution vector of the linear equation system:" << std::endl;
     auto solution = system.solution();
-    std::cout << solution << std::endl << std::endl;
-
-    return solution.to_vector();
+    return Elements(std::cbegin(solution), std::cend(solution));
   }
 
-  static std::vector<Element>
-  error_values_forney(const std::vector<Element> &syndromes,
-                      const std::vector<Element> &zeroes) {
-    return error_values(syndromes, zeroes);
+  /* Forney's algorithm. With the error locator Λ(x) = x^v Σ(1/x), the error
+   * evaluator solves the key equation
+   *
+   *   Ω(x) = S(x) Λ(x) mod x^(2t),   S(x) = Σ_j s_j x^j,
+   *
+   * and the error at X_i is y_i = X_i^(1 - mu) Ω(X_i^-1) / Λ'(X_i^-1). A
+   * constant factor of Σ(x), as the riBM leaves it, cancels. In characteristic
+   * 2 the derivative Λ'(x) consists of the odd terms of Λ(x) divided by x. */
+  static Elements error_values(const Elements &syndromes, const Locator &sigma,
+                               const Elements &zeroes, forney_tag) {
+    constexpr unsigned order = (1u << q) - 1;
+    const auto v = static_cast<size_t>(sigma.degree());
+    const size_t size = syndromes.size();
+    /* X_i^(1 - mu) = (X_i^-1)^(mu - 1) */
+    const size_t shift = (mu % order + order - 1) % order;
+
+    /* Λ_j = σ_(v - j) */
+    Locator omega(size, Element(0));
+    for (size_t k = 0; k < size; k++) {
+      for (size_t j = 0; j <= std::min(k, v); j++)
+        omega[k] = omega[k] + sigma[v - j] * syndromes[k - j];
+    }
+
+    Elements values;
+    for (const auto &zero : zeroes) {
+      const Element x = zero.inverse();
+      const Element x2 = x * x;
+
+      Element numerator(0);
+      for (size_t k = size; k--;)
+        numerator = numerator * x + omega[k];
+
+      /* Λ'(x) = Λ_1 + Λ_3 x^2 + Λ_5 x^4 + ... */
+      Element denominator(0);
+      for (size_t j = v - (v + 1) % 2; j <= v; j -= 2)
+        denominator = denominator * x2 + sigma[v - j];
+
+      const size_t power = shift * (order - zero.power()) % order;
+      values.push_back(Element::from_power(static_cast<unsigned>(power)) *
+                       numerator / denominator);
+    }
+    return values;
   }
 
+  rs(const Polynomial &g_, compile_time)
+      : Base(g_, h(g_, compile_time()), syndrome_roots(compile_time()),
+             designed_distance(g_, compile_time()),
+             [](const Elements &syndromes, const Locator &sigma,
+                const Elements &zeroes) {
+               return error_values(syndromes, sigma, zeroes, Error());
+             }) {}
+
 public:
-  rs() : Base(g(), syndromes(), &error_values) {}
+  rs() : rs(g(compile_time()), compile_time()) {}
 
   /* TODO: typedef codeword type? */
   /* InputSequence concepts:
@@ -3,7 +3,6 @@
 #include <vector>
 #include <utility>
 #include <limits>
-#include <numeric>
 #include <cmath>
 #include <tuple>
 #include <functional>
@@ -76,129 +75,207 @@ template <typename T> constexpr int signum(const T &val) {
   return (T(0) < val) - (val < T(0));
 }
 
-template <typename T, typename U>
-inline auto syndrome(const matrix<T> &H, const std::vector<U> &b) {
-  const auto syndromes = H * b;
-  return std::none_of(std::cbegin(syndromes), std::cend(syndromes),
-                      [](const auto &bit) { return bool(bit); });
-}
+/* H in the forms the Min-Sum decoder works on: dense, the columns of the
+ * non-zero elements of every row for the message updates and packed over GF(2)
+ * for the syndrome check. Immutable once built. */
+template <typename U> class parity_check_matrix {
+  matrix<U> dense_;
+  gf2_matrix packed_;
+  /* the non-zero columns of row i are columns[offsets[i], offsets[i + 1]) */
+  std::vector<size_t> offsets;
+  std::vector<size_t> columns_;
+
+public:
+  explicit parity_check_matrix(matrix<U> H)
+      : dense_(std::move(H)), packed_(dense_), offsets(1, 0) {
+    offsets.reserve(dense_.rows() + 1);
+    for (size_t row = 0; row < dense_.rows(); row++) {
+      const U *h = dense_[row].data();
+      for (size_t col = 0; col < dense_.columns(); col++) {
+        if (h[col])
+          columns_.push_back(col);
+      }
+      offsets.push_back(columns_.size());
+    }
+  }
+
+  size_t rows() const noexcept { return dense_.rows(); }
+  size_t columns() const noexcept { return dense_.columns(); }
+
+  const matrix<U> &dense() const noexcept { return dense_; }
+  const gf2_matrix &packed() const noexcept { return packed_; }
+
+  const size_t *begin(const size_t row) const noexcept {
+    return columns_.data() + offsets[row];
+  }
+  const size_t *end(const size_t row) const noexcept {
+    return columns_.data() + offsets[row + 1];
+  }
+};
 
 template <typename U, typename R>
-std::vector<R> column_sum(const matrix<U> &H, const matrix<R> &r) {
-  std::vector<R> col_sums(H.columns(), R(0));
+void column_sum(const parity_check_matrix<U> &H, const matrix<R> &r,
+                std::vector<R> &col_sums) {
+  std::fill(std::begin(col_sums), std::end(col_sums), R(0));
   for (size_t row = 0; row < H.rows(); row++) {
-    for (size_t col = 0; col < H.columns(); col++) {
-      if (H.at(row).at(col)) {
-        col_sums.at(col) += r.at(row).at(col);
-      }
-    }
+    const R *r_ = r[row].data();
+    for (auto col = H.begin(row); col != H.end(row); ++col)
+      col_sums[*col] += r_[*col];
   }
+}
 
+template <typename U, typename R>
+std::vector<R> column_sum(const parity_check_matrix<U> &H,
+                          const matrix<R> &r) {
+  std::vector<R> col_sums(H.columns(), R(0));
+  column_sum(H, r, col_sums);
   return col_sums;
 }
 
 /* check node update */
 template <typename U, typename Q, typename R, typename Functor>
-void horizontal__(const matrix<U> &H, const matrix<Q> &q, matrix<R> &r,
-                  Functor &&fn) {
-  const size_t rows = H.rows();
-  const size_t cols = H.columns();
-  for (size_t row = 0; row < rows; row++) {
-    for (size_t col = 0; col < cols; col++) {
-      if (H.at(row).at(col)) {
-        int sign = 1;
-        Q min = std::numeric_limits<Q>::max();
-
-        for (size_t i = 0; i < cols; i++) {
-          if (i != col && H.at(row).at(i)) {
-            sign *= signum(q.at(row).at(i));
-            min = std::min(min, std::abs(q.at(row).at(i)));
-          }
+void horizontal__(const parity_check_matrix<U> &H, const matrix<Q> &q,
+                  matrix<R> &r, Functor &&fn) {
+  for (size_t row = 0; row < H.rows(); row++) {
+    const Q *q_ = q[row].data();
+    R *r_ = r[row].data();
+    const size_t *first = H.begin(row);
+    const size_t *last = H.end(row);
+    for (auto col = first; col != last; ++col) {
+      int sign = 1;
+      Q min = std::numeric_limits<Q>::max();
+
+      for (auto i = first; i != last; ++i) {
+        if (i != col) {
+          sign *= signum(q_[*i]);
+          min = std::min(min, std::abs(q_[*i]));
         }
-        r.at(row).at(col) = static_cast<R>(sign * fn(min));
       }
+      r_[*col] = static_cast<R>(sign * fn(min));
     }
   }
 }
 
 /* symbol node update */
 template <typename U, typename Q, typename R, typename Functor>
-void vertical__(const matrix<U> &H, const std::vector<Q> y, const matrix<R> &r,
+void vertical__(const parity_check_matrix<U> &H, const std::vector<Q> &y,
+                const matrix<R> &r, const std::vector<R> &col_sums,
                 matrix<Q> &q, Functor &&fn) {
-  std::vector<R> col_sums(column_sum(H, r));
-
-  const size_t rows = H.rows();
-  const size_t cols = H.columns();
-  for (size_t row = 0; row < rows; row++) {
-    for (size_t col = 0; col < cols; col++) {
-      if (H.at(row).at(col)) {
-        const auto exclusive_colsum = col_sums.at(col) - r.at(row).at(col);
-        q.at(row).at(col) = fn(exclusive_colsum, y.at(col), q.at(row).at(col));
-      }
+  for (size_t row = 0; row < H.rows(); row++) {
+    const R *r_ = r[row].data();
+    Q *q_ = q[row].data();
+    for (auto col = H.begin(row); col != H.end(row); ++col) {
+      const auto exclusive_colsum = col_sums[*col] - r_[*col];
+      q_[*col] = fn(exclusive_colsum, y[*col], q_[*col]);
     }
   }
 }
 
+template <typename U, typename Q, typename R, typename Functor>
+void vertical__(const parity_check_matrix<U> &H, const std::vector<Q> &y,
+                const matrix<R> &r, matrix<Q> &q, Functor &&fn) {
+  vertical__(H, y, r, column_sum(H, r), q, std::forward<Functor>(fn));
+}
+
 template <typename U, typename Q, typename R,
           typename Result_t = typename std::common_type<Q, R>::type>
-std::vector<Result_t> likelihood(const std::vector<Q> &y, const matrix<U> &H,
+std::vector<Result_t> likelihood(const std::vector<Q> &y,
+                                 const parity_check_matrix<U> &H,
                                  const matrix<R> &r) {
-  std::vector<Result_t> result;
-  result.reserve(y.size());
-  std::copy(std::cbegin(y), std::cend(y), std::back_inserter(result));
+  std::vector<Result_t> result(std::cbegin(y), std::cend(y));
+  const std::vector<R> col_sums(column_sum(H, r));
+  for (size_t col = 0; col < H.columns(); col++)
+    result[col] += col_sums[col];
 
-  for (size_t row = 0; row < H.rows(); row++) {
-    for (size_t col = 0; col < H.columns(); col++) {
-      if (H.at(row).at(col)) {
-        result.at(col) += r.at(row).at(col);
+  return result;
+}
+
+/* The messages and decisions of the Min-Sum decoder. A workspace is reused
+ * by the decodes of one thread, so that they do not allocate memory once its
+ * buffers have grown to the size of H. */
+template <typename Q, typename R, typename U> struct min_sum_workspace {
+  matrix<Q> q;
+  matrix<R> r;
+  std::vector<R> col_sums;
+  /* likelihoods and hard decision of the last iteration */
+  std::vector<R> L;
+  std::vector<U> b;
+  std::vector<uint64_t> packed;
+
+  /* the messages of the non-zero elements of H are zero, as in new matrices */
+  void reset(const parity_check_matrix<U> &H) {
+    if (q.rows() != H.rows() || q.columns() != H.columns()) {
+      q = matrix<Q>(H.rows(), H.columns());
+      r = matrix<R>(H.rows(), H.columns());
+    } else {
+      for (size_t row = 0; row < H.rows(); row++) {
+        Q *q_ = q[row].data();
+        R *r_ = r[row].data();
+        for (auto col = H.begin(row); col != H.end(row); ++col) {
+          q_[*col] = Q(0);
+          r_[*col] = R(0);
+        }
       }
     }
+    col_sums.assign(H.columns(), R(0));
+    L.resize(H.columns());
+    b.resize(H.columns());
+    packed.resize(H.packed().words());
   }
+};
 
-  return result;
-}
-
-template <unsigned iterations, typename U = unsigned, typename R, typename Q,
+/* The decoded word is ws.b and its likelihoods ws.L; returns the iteration
+ * it was found in, or iterations for a decoding failure. */
+template <unsigned iterations, typename U, typename R, typename Q,
           typename Func_h, typename Func_v>
-std::tuple<std::vector<U>, std::vector<R>, unsigned>
-min_sum__(const matrix<U> &H, const std::vector<Q> &y, Func_h &&hor,
-          Func_v &&vert) {
-
-  matrix<Q> q(H.rows(), H.columns());
-  matrix<R> r(H.rows(), H.columns());
-  std::vector<R> col_sums(y.size());
-  std::vector<R> L(y.size());
-  std::vector<U> b(y.size());
+unsigned min_sum__(const parity_check_matrix<U> &H, const std::vector<Q> &y,
+                   min_sum_workspace<Q, R, U> &ws, Func_h &&hor,
+                   Func_v &&vert) {
+  const gf2_matrix &parity_checks = H.packed();
+  ws.reset(H);
 
   for (unsigned iteration = 0; iteration < iterations; iteration++) {
-    vertical__(H, y, r, q, vert);
-    horizontal__(H, q, r, hor);
+    /* r is unchanged since the column sums of the previous iteration */
+    vertical__(H, y, ws.r, ws.col_sums, ws.q, vert);
+    horizontal__(H, ws.q, ws.r, hor);
+    column_sum(H, ws.r, ws.col_sums);
 
-    /* TODO re-use in vertical__ */
-    col_sums = column_sum(H, r);
-
-    std::transform(std::cbegin(col_sums), std::cend(col_sums), std::cbegin(y),
-                   std::begin(L),
+    std::transform(std::cbegin(ws.col_sums), std::cend(ws.col_sums),
+                   std::cbegin(y), std::begin(ws.L),
                    [](const R &lhs, const Q &rhs) { return lhs + R(rhs); });
-    hard_decision<U>(std::cbegin(L), std::cend(L), std::begin(b));
+    pack_hard_decision(std::cbegin(ws.L), std::cend(ws.L), ws.packed.data());
 
-    if (syndrome(H, b))
-      return std::make_tuple(b, L, iteration);
+    if (parity_checks.in_kernel(ws.packed.data())) {
+      hard_decision<U>(std::cbegin(ws.L), std::cend(ws.L), std::begin(ws.b));
+      return iteration;
+    }
   }
 
 #if 0
-  std::cout << H << std::endl;
-  
-  std::vector<U> b(hard_decision<U>(L));
-  for (const auto &bit : b)
+  std::cout << H.dense() << std::endl;
+
+  for (const auto &bit : ws.b)
     std::cout << static_cast<unsigned>(bit);
   std::cout << std::endl;
 
-  for (const auto &l : L)
+  for (const auto &l : ws.L)
     std::cout << l;
   std::cout << std::endl;
 #endif
-  throw decoding_failure("Decoding failure");
+  return iterations;
+}
+
+template <unsigned iterations, typename U = unsigned, typename R, typename Q,
+          typename Func_h, typename Func_v>
+std::tuple<std::vector<U>, std::vector<R>, unsigned>
+min_sum__(const parity_check_matrix<U> &H, const std::vector<Q> &y,
+          Func_h &&hor, Func_v &&vert) {
+  min_sum_workspace<Q, R, U> ws;
+  const unsigned iteration = min_sum__<iterations>(
+      H, y, ws, std::forward<Func_h>(hor), std::forward<Func_v>(vert));
+  if (iteration == iterations)
+    throw decoding_failure("Decoding failure");
+  return std::make_tuple(std::move(ws.b), std::move(ws.L), iteration);
 }
 
 template <typename R> R unmodified_horizontal(const R &arg) { return arg; }
@@ -217,48 +294,47 @@ R normalised_vertical(const R &arg, const Q &y, const Q &, const R &beta) {
   return beta * arg + R(y);
 }
 
-template <typename R, typename U = unsigned, typename Q, unsigned Iterations>
-std::tuple<std::vector<U>, std::vector<R>, unsigned>
-min_sum(const matrix<U> &H, const std::vector<Q> &y,
-        min_sum_tag<Iterations>) {
+template <typename R, typename U, typename Q, unsigned Iterations>
+unsigned min_sum(const parity_check_matrix<U> &H, const std::vector<Q> &y,
+                 min_sum_workspace<Q, R, U> &ws, min_sum_tag<Iterations>) {
   return min_sum__<min_sum_tag<Iterations>::iterations, U, R, Q>(
-      H, y, unmodified_horizontal<R>, unmodified_vertical<R, Q>);
+      H, y, ws, unmodified_horizontal<R>, unmodified_vertical<R, Q>);
 }
 
-template <typename R, typename U = unsigned, typename Q, unsigned Iterations,
-          typename T>
-std::tuple<std::vector<U>, std::vector<R>, unsigned>
-min_sum(const matrix<U> &H, const std::vector<Q> &y,
-        normalized_min_sum_tag<Iterations, T>) {
+template <typename R, typename U, typename Q, unsigned Iterations, typename T>
+unsigned min_sum(const parity_check_matrix<U> &H, const std::vector<Q> &y,
+                 min_sum_workspace<Q, R, U> &ws,
+                 normalized_min_sum_tag<Iterations, T>) {
   auto alpha = normalized_min_sum_tag<Iterations, T>::alpha;
   return min_sum__<normalized_min_sum_tag<Iterations, T>::iterations, U, R, Q>(
-      H, y, std::bind(normalised_horizontal<R>, std::placeholders::_1, alpha),
+      H, y, ws,
+      std::bind(normalised_horizontal<R>, std::placeholders::_1, alpha),
       unmodified_vertical<R, Q>);
 }
 
-template <typename R, typename U = unsigned, typename Q, unsigned Iterations,
-          typename T>
-std::tuple<std::vector<U>, std::vector<R>, unsigned>
-min_sum(const matrix<U> &H, const std::vector<Q> &y,
-        offset_min_sum_tag<Iterations, T>) {
+template <typename R, typename U, typename Q, unsigned Iterations, typename T>
+unsigned min_sum(const parity_check_matrix<U> &H, const std::vector<Q> &y,
+                 min_sum_workspace<Q, R, U> &ws,
+                 offset_min_sum_tag<Iterations, T>) {
   return min_sum__<offset_min_sum_tag<Iterations, T>::iterations, U, R, Q>(
-      H, y, [](const R &min) {
-              auto beta = offset_min_sum_tag<Iterations, T>::beta;
-              using Result_t =
-                  typename std::common_type<R, decltype(beta)>::type;
+      H, y, ws, [](const R &min) {
+                  auto beta = offset_min_sum_tag<Iterations, T>::beta;
+                  using Result_t =
+                      typename std::common_type<R, decltype(beta)>::type;
 
-              return std::max(min - beta, Result_t(0));
-            },
+                  return std::max(min - beta, Result_t(0));
+                },
       unmodified_vertical<R, Q>);
 }
 
 /* http://dud.inf.tu-dresden.de/LDPC/doc/scms/ */
-template <typename R, typename U = unsigned, typename Q, unsigned Iterations>
-std::tuple<std::vector<U>, std::vector<R>, unsigned>
-min_sum(const matrix<U> &H, const std::vector<Q> &y,
-        self_correcting_1_min_sum_tag<Iterations>) {
+template <typename R, typename U, typename Q, unsigned Iterations>
+unsigned min_sum(const parity_check_matrix<U> &H, const std::vector<Q> &y,
+                 min_sum_workspace<Q, R, U> &ws,
+                 self_correcting_1_min_sum_tag<Iterations>) {
   return min_sum__<Iterations, U, R, Q>(
-      H, y, unmodified_horizontal<R>, [](const R &r, const Q &y_, const Q &q) {
+      H, y, ws, unmodified_horizontal<R>,
+      [](const R &r, const Q &y_, const Q &q) {
         auto tmp = r + R(y_);
         if (signum(q) == 0 || signum(q) == signum(tmp))
           return tmp;
@@ -267,12 +343,13 @@ min_sum(const matrix<U> &H, const std::vector<Q> &y,
       });
 }
 
-template <typename R, typename U = unsigned, typename Q, unsigned Iterations>
-std::tuple<std::vector<U>, std::vector<R>, unsigned>
-min_sum(const matrix<U> &H, const std::vector<Q> &y,
-        self_correcting_2_min_sum_tag<Iterations>) {
+template <typename R, typename U, typename Q, unsigned Iterations>
+unsigned min_sum(const parity_check_matrix<U> &H, const std::vector<Q> &y,
+                 min_sum_workspace<Q, R, U> &ws,
+                 self_correcting_2_min_sum_tag<Iterations>) {
   return min_sum__<Iterations, U, R, Q>(
-      H, y, unmodified_horizontal<R>, [](const R &r, const Q &y_, const Q &q) {
+      H, y, ws, unmodified_horizontal<R>,
+      [](const R &r, const Q &y_, const Q &q) {
         auto tmp = r + R(y_);
         if (tmp * R(q) > 0)
           return tmp;
@@ -281,15 +358,34 @@ min_sum(const matrix<U> &H, const std::vector<Q> &y,
       });
 }
 
-template <typename R, typename U = unsigned, typename Q, unsigned Iterations,
+template <typename R, typename U, typename Q, unsigned Iterations,
           typename Alpha, typename Beta>
-std::tuple<std::vector<U>, std::vector<R>, unsigned>
-min_sum(const matrix<U> &H, const std::vector<Q> &y,
-        normalized_2d_min_sum_tag<Iterations, Alpha, Beta>) {
+unsigned min_sum(const parity_check_matrix<U> &H, const std::vector<Q> &y,
+                 min_sum_workspace<Q, R, U> &ws,
+                 normalized_2d_min_sum_tag<Iterations, Alpha, Beta>) {
   auto alpha = normalized_2d_min_sum_tag<Iterations, Alpha, Beta>::alpha;
   auto beta = normalized_2d_min_sum_tag<Iterations, Alpha, Beta>::beta;
   return min_sum__<Iterations, U, R, Q>(
-      H, y, std::bind(normalised_horizontal<R>, std::placeholders::_1, alpha),
+      H, y, ws,
+      std::bind(normalised_horizontal<R>, std::placeholders::_1, alpha),
       std::bind(normalised_vertical<R, Q>, std::placeholders::_1,
                 std::placeholders::_2, std::placeholders::_3, beta));
 }
+
+/* with a workspace of its own, throws decoding_failure */
+template <typename R, typename U = unsigned, typename Q, typename Tag>
+std::tuple<std::vector<U>, std::vector<R>, unsigned>
+min_sum(const parity_check_matrix<U> &H, const std::vector<Q> &y, Tag tag) {
+  min_sum_workspace<Q, R, U> ws;
+  const unsigned iteration = min_sum(H, y, ws, tag);
+  if (iteration == Tag::iterations)
+    throw decoding_failure("Decoding failure");
+  return std::make_tuple(std::move(ws.b), std::move(ws.L), iteration);
+}
+
+/* for a single decode; codes keep their parity_check_matrix */
+template <typename R, typename U = unsigned, typename Q, typename Tag>
+std::tuple<std::vector<U>, std::vector<R>, unsigned>
+min_sum(const matrix<U> &H, const std::vector<Q> &y, Tag tag) {
+  return min_sum<R, U>(parity_check_matrix<U>(H), y, tag);
+}
@@ -7,6 +7,9 @@
 #include <vector>
 #include <sstream>
 
+#include "codes/codes.h"
+#include "math/matrix.h"
+
 class uncoded {
   template <typename Out, typename In,
             typename std::enable_if<std::is_signed<In>::value>::type * =
@@ -26,6 +29,9 @@ public:
   static constexpr double rate = 0.5;
   const unsigned n;
 
+  /* nothing to keep between words */
+  struct workspace {};
+
   explicit uncoded(const unsigned l) : n(l) {}
 
   std::string to_string() const {
@@ -44,6 +50,17 @@ public:
     std::fill_n(std::back_inserter(r), n - b.size(), Return_type(0));
     return r;
   }
+
+  template <typename InputSequence, typename Return_type>
+  decode_status correct_into(const InputSequence &b,
+                             vector_view<Return_type> out,
+                             workspace &) const {
+    auto last = std::transform(
+        std::cbegin(b), std::cend(b), std::begin(out),
+        &binary_output<Return_type, typename InputSequence::value_type>);
+    std::fill(last, std::end(out), Return_type(0));
+    return decode_status::corrected(0);
+  }
 };
 
 constexpr double uncoded::rate;
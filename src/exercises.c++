@@ -1,6 +1,9 @@
 #include <vector>
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <string>
 
 #include "codes/bch.h"
 #include "codes/rs.h"
@@ -273,6 +276,37 @@ static void task_6_10() {
   std::cout << "EUKLID: " << euklid.correct(a) << std::endl;
 }
 
+/* Soft decision decoding of a BPSK word with one wrong sign, for every
+ * encoder. */
+template <typename Code> static void soft_decision(const std::string &name) {
+  const Code code;
+  const std::vector<uint8_t> a({ 1, 0, 1, 1, 0, 0, 1 });
+  std::vector<uint8_t> c(Code::n);
+  code.encode(a, std::begin(c));
+
+  std::vector<float> y;
+  std::transform(std::cbegin(c), std::cend(c), std::back_inserter(y),
+                 [](const uint8_t bit) { return bit ? -1.0f : 1.0f; });
+  y.at(3) = -y.at(3) * 0.5f;
+
+  const auto b = code.template decode<std::vector<float>, uint8_t>(y);
+  std::cout << name << ": " << b << std::endl;
+  expect_equal(a, b);
+}
+
+static void soft_decision() {
+  std::cout << std::endl << "Soft decision" << std::endl << std::endl;
+
+  soft_decision<cyclic::primitive_bch<4, dmin<5>, min_sum_tag<50> > >(
+      "division");
+  soft_decision<cyclic::primitive_bch<4, dmin<5>, min_sum_tag<50>, 15,
+                                      cyclic::generator_matrix_tag> >(
+      "generator matrix");
+  soft_decision<cyclic::primitive_bch<4, dmin<5>, min_sum_tag<50>, 15,
+                                      cyclic::multiplication_tag> >(
+      "multiplication");
+}
+
 int main() {
   task_6_1();
   task_6_2();
@@ -286,4 +320,6 @@ int main() {
   task_6_9();
 
   task_6_10();
+
+  soft_decision();
 }
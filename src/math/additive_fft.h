@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "math/galois.h"
+
+namespace math {
+
+namespace detail {
+/* Taylor expansion at x^2 + x in place: afterwards f = Σ_i (f_2i + f_2i+1 x)
+ * (x^2 + x)^i. size is a power of two. With t a power of two
+ * (x^2 + x)^t = x^2t + x^t, so a block A + x^t B + x^2t C + x^3t D of 4t
+ * coefficients is (A + x^t (B + C + D)) + (x^2 + x)^t (C + D + x^t D), and
+ * both halves are expanded further. */
+template <typename Element> void taylor(Element *f, const size_t size) {
+  for (size_t t = size / 4; t; t /= 2) {
+    for (size_t block = 0; block < size; block += 4 * t) {
+      Element *b = f + block + t;
+      Element *c = b + t;
+      const Element *d = c + t;
+      for (size_t i = 0; i < t; i++) {
+        c[i] = c[i] + d[i];
+        b[i] = b[i] + c[i];
+      }
+    }
+  }
+}
+
+/* out[i] = f(Σ_j i_j basis[j]), where i_j are the binary digits of i, for the
+ * 2^m points spanned by basis[0, m). f has at most 2^m coefficients. */
+template <typename Element>
+void additive_fft(std::vector<Element> f, const Element *basis, const size_t m,
+                  Element *out) {
+  const size_t points = size_t(1) << m;
+  while (!f.empty() && !f.back())
+    f.pop_back();
+  if (f.size() <= 1) {
+    std::fill(out, out + points, f.empty() ? Element(0) : f.front());
+    return;
+  }
+
+  /* g(x) = f(β x) with β = basis[m - 1], expanded at x^2 + x:
+   * g(x) = g_0(x^2 + x) + x g_1(x^2 + x) */
+  const Element beta = basis[m - 1];
+  Element power(1);
+  for (auto &coefficient : f) {
+    coefficient = coefficient * power;
+    power = power * beta;
+  }
+  size_t size = 2;
+  while (size < f.size())
+    size *= 2;
+  f.resize(size, Element(0));
+  taylor(f.data(), size);
+
+  std::vector<Element> g0(size / 2);
+  std::vector<Element> g1(size / 2);
+  for (size_t i = 0; i < size / 2; i++) {
+    g0[i] = f[2 * i];
+    g1[i] = f[2 * i + 1];
+  }
+
+  /* γ = basis / β spans G and δ = γ^2 + γ spans the image of G under
+   * x^2 + x. Both halves of the points β G and β (G + 1) map to it. */
+  const size_t half = points / 2;
+  std::vector<Element> gamma(m - 1);
+  std::vector<Element> delta(m - 1);
+  for (size_t i = 0; i + 1 < m; i++) {
+    gamma[i] = basis[i] / beta;
+    delta[i] = gamma[i] * gamma[i] + gamma[i];
+  }
+
+  additive_fft(std::move(g0), delta.data(), m - 1, out);
+  additive_fft(std::move(g1), delta.data(), m - 1, out + half);
+
+  /* G[i] is G[i] without its lowest set bit plus the γ of that bit */
+  std::vector<Element> span(half, Element(0));
+  for (size_t i = 1; i < half; i++)
+    span[i] = span[i & (i - 1)] +
+              gamma[static_cast<size_t>(__builtin_ctzll(i))];
+
+  for (size_t i = 0; i < half; i++) {
+    const Element w = out[i] + span[i] * out[half + i];
+    out[half + i] = w + out[half + i];
+    out[i] = w;
+  }
+}
+}
+
+/* Values of the polynomial with the coefficients [first, last), lowest degree
+ * first, at all 2^m elements of GF(2^m), by the additive FFT of Gao and
+ * Mateer in O(2^m m^2) instead of O(2^m deg(p)) multiplications. Value i is
+ * the value at the element with storage value i. */
+template <typename Element>
+std::vector<Element> additive_fft(const Element *first, const Element *last) {
+  using storage_type = typename Element::storage_type;
+  constexpr size_t m = Element::digits;
+  static_assert(m < 32, "The additive FFT needs 2^m values in memory.");
+
+  Element basis[m];
+  for (size_t i = 0; i < m; i++)
+    basis[i] = Element(static_cast<storage_type>(uint64_t(1) << i),
+                       gf::unchecked_tag{});
+
+  std::vector<Element> values(size_t(1) << m);
+  detail::additive_fft(std::vector<Element>(first, last), basis, m,
+                       values.data());
+  return values;
+}
+}
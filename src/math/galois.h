@@ -2,6 +2,13 @@
 
 #include <array>
 #include <cassert>
+#include <type_traits>
+#include <iterator>
+#include <cstddef>
+
+#ifdef __PCLMUL__
+#include <wmmintrin.h>
+#endif
 
 namespace math {
 namespace detail {
@@ -15,13 +22,15 @@ template <> struct log2<1> {
   static constexpr long value = 0;
 };
 
-static constexpr std::array<unsigned, 9> modular_polynomials = {
-  { 0, 0x3, 0x7, 0xb, 0x13, 0x25, 0x43, 0x83, 0x11d }
+/* primitive polynomials for GF(2^q), q = 1 ... 16 */
+static constexpr std::array<unsigned, 17> modular_polynomials = {
+  { 0, 0x3, 0x7, 0xb, 0x13, 0x25, 0x43, 0x83, 0x11d, 0x211, 0x409, 0x805,
+    0x1053, 0x201b, 0x4443, 0x8003, 0x1100b }
 };
 
-/* uint16_t allows galois fields up to 2^15 to be used. */
-template <uint16_t poly> struct modular_polynomial {
-  static constexpr uint16_t value = poly;
+/* uint32_t allows galois fields up to 2^31 to be used. */
+template <uint32_t poly> struct modular_polynomial {
+  static constexpr uint32_t value = poly;
 };
 
 template <int size_type> struct uint_t_helper;
@@ -53,41 +62,213 @@ template <unsigned bits> struct uint_t {
 };
 }
 
-/* uint16_t allows galois fields up to 2^15 to be used. */
-template <uint16_t poly> struct modular_polynomial {
-  static constexpr uint16_t value = poly;
+/* uint32_t allows galois fields up to 2^31 to be used. */
+template <uint32_t poly> struct modular_polynomial {
+  static constexpr uint32_t value = poly;
 };
 
+namespace gf {
+/* Constructs an element without validating its value. */
+struct unchecked_tag {};
+
+/* Multiplication via log/exp tables. Fast for small fields, where both tables
+ * stay in L1. */
+struct log_table_tag {};
+/* Branch-free carry-less multiplication followed by reduction by the modular
+ * polynomial. Uses PCLMULQDQ if available. */
+struct clmul_tag {};
+/* GF(2^(2k)) as quadratic extension y^2 + y + β of GF(2^k); multiplication
+ * and inversion only need the (small) tables of GF(2^k). See math/tower.h */
+struct tower_tag {};
+/* Fields of odd characteristic; residues are kept in Montgomery form, so that
+ * multiplication needs no division. See math/prime_field.h */
+struct montgomery_tag {};
+}
+
 namespace detail {
-template <unsigned q> struct default_modular_polynomial {
+/* Carry-less product of a and b, where a and b have at most 'bits' digits. */
+template <unsigned bits> inline uint64_t clmul(const uint64_t a, const uint64_t b) {
+  static_assert(bits <= 32, "The product has to fit into 64 bits.");
+#ifdef __PCLMUL__
+  const __m128i product = _mm_clmulepi64_si128(
+      _mm_cvtsi64_si128(static_cast<long long>(a)),
+      _mm_cvtsi64_si128(static_cast<long long>(b)), 0x00);
+  return static_cast<uint64_t>(_mm_cvtsi128_si64(product));
+#else
+  uint64_t product = 0;
+  for (unsigned bit = 0; bit < bits; bit++)
+    product ^= (a << bit) & (0 - ((b >> bit) & 1));
+  return product;
+#endif
+}
+
+/* floor(x^(2 * power) / modular_polynomial) for Barrett reduction */
+constexpr uint64_t barrett_constant(const unsigned power,
+                                    const uint64_t modular_polynomial) {
+  uint64_t remainder = uint64_t(1) << (2 * power);
+  uint64_t quotient = 0;
+  for (unsigned bit = 2 * power + 1; bit-- > power;) {
+    if (remainder & (uint64_t(1) << bit)) {
+      quotient |= uint64_t(1) << (bit - power);
+      remainder ^= modular_polynomial << (bit - power);
+    }
+  }
+  return quotient;
+}
+
+/* Reduce a product of two field elements, i.e. a polynomial of degree
+ * 2 * (power - 1) at most, by the modular polynomial. */
+template <unsigned power, uint64_t modular_polynomial>
+inline uint64_t reduce(uint64_t product) {
+#ifdef __PCLMUL__
+  constexpr uint64_t mu = barrett_constant(power, modular_polynomial);
+  const uint64_t quotient = clmul<power + 1>(product >> power, mu) >> power;
+  product ^= clmul<power + 1>(quotient, modular_polynomial);
+#else
+  for (unsigned bit = 2 * power - 1; bit-- > power;)
+    product ^= (0 - ((product >> bit) & 1)) &
+               (modular_polynomial << (bit - power));
+#endif
+  return product & ((uint64_t(1) << power) - 1);
+}
+
+/* std::array has no constexpr non-const accessors in C++14. */
+template <typename T, size_t N> struct table {
+  T values[N];
+
+  constexpr const T &operator[](const size_t i) const noexcept {
+    return values[i];
+  }
+  constexpr T &operator[](const size_t i) noexcept { return values[i]; }
+  constexpr const T *begin() const noexcept { return values; }
+  constexpr const T *end() const noexcept { return values + N; }
+};
+
+/* exp[i] = α^i for i < 2 * (2^power - 1); the table wraps around after
+ * 2^power - 1 entries, so that the sum of two logarithms can be looked up
+ * without reduction. The last entry is 0. */
+template <typename T, size_t N>
+constexpr table<T, N> exp_table(const unsigned power,
+                                const uint64_t modular_polynomial) {
+  const size_t n = (size_t(1) << power) - 1;
+  table<T, N> exp{};
+  uint64_t polynomial = 1;
+  for (size_t i = 0; i < n; i++) {
+    exp[i] = static_cast<T>(polynomial);
+    exp[i + n] = static_cast<T>(polynomial);
+
+    polynomial <<= 1;
+    if (polynomial & (uint64_t(1) << power))
+      polynomial ^= modular_polynomial;
+  }
+  exp[2 * n] = 1;
+  exp[2 * n + 1] = 0;
+  return exp;
+}
+
+/* log[x] = i with α^i = x. log[0] is 0, arithmetic masks zeroes out.
+ * One entry per element suffices, since the exp table wraps around. */
+template <typename T, size_t N>
+constexpr table<T, N> log_table(const unsigned power,
+                                const uint64_t modular_polynomial) {
+  const size_t n = (size_t(1) << power) - 1;
+  table<T, N> log{};
+  uint64_t polynomial = 1;
+  for (size_t i = 0; i < n; i++) {
+    log[polynomial] = static_cast<T>(i);
+
+    polynomial <<= 1;
+    if (polynomial & (uint64_t(1) << power))
+      polynomial ^= modular_polynomial;
+  }
+  return log;
+}
+
+/* a * b mod modular_polynomial, for constant expressions */
+constexpr uint64_t multiply_mod(uint64_t a, uint64_t b, const unsigned power,
+                                const uint64_t modular_polynomial) {
+  uint64_t product = 0;
+  for (; b; b >>= 1) {
+    if (b & 1)
+      product ^= a;
+    a <<= 1;
+    if (a & (uint64_t(1) << power))
+      a ^= modular_polynomial;
+  }
+  return product;
+}
+
+/* Tr(x) = x + x^2 + x^4 + ... + x^(2^(power - 1)) */
+constexpr uint64_t trace(uint64_t x, const unsigned power,
+                         const uint64_t modular_polynomial) {
+  uint64_t sum = 0;
+  for (unsigned i = 0; i < power; i++) {
+    sum ^= x;
+    x = multiply_mod(x, x, power, modular_polynomial);
+  }
+  return sum;
+}
+
+/* Smallest β with Tr(β) = 1, i.e. y^2 + y + β is irreducible over
+ * GF(2^power). */
+constexpr uint64_t tower_constant(const unsigned power,
+                                  const uint64_t modular_polynomial) {
+  uint64_t beta = 1;
+  while (trace(beta, power, modular_polynomial) != 1)
+    beta++;
+  return beta;
+}
+
+template <long power, long prime = 2> struct default_arithmetic {
+  using type = gf::montgomery_tag;
+};
+
+/* Tables are cheaper as long as they fit comfortably into the L1 cache, i.e.
+ * 3 * 2^12 entries of two bytes each. Beyond GF(2^16) tables are impractical
+ * and fields are built as extensions of smaller fields. */
+template <long power> struct default_arithmetic<power, 2> {
+  using type = typename std::conditional<
+      (power > 16), gf::tower_tag,
+      typename std::conditional<(power > 12), gf::clmul_tag,
+                                gf::log_table_tag>::type>::type;
+};
+
+template <unsigned q, bool = (q > 16)> struct default_modular_polynomial {
   static_assert(q > 0, "GF(2^0) does not make sense. Choose q > 0.");
-  static_assert(q < 9, "modular polynomial for GF(q), q > 2^8 have to "
-                       "specified manually (or the list of default modular "
-                       "polynomials has to be extended.");
   using type =
       ::math::modular_polynomial<std::get<q>(detail::modular_polynomials)>;
 };
+
+/* For tower fields the "modular polynomial" is y^2 + y + β over GF(2^(q/2));
+ * its value is β. */
+template <unsigned q> struct default_modular_polynomial<q, true> {
+  static_assert(q % 2 == 0 && q <= 32,
+                "modular polynomial for GF(2^q), q > 16 is only available for "
+                "even q up to 32 (or has to be specified manually).");
+  using type = ::math::modular_polynomial<static_cast<uint32_t>(
+      tower_constant(q / 2, std::get<q / 2>(detail::modular_polynomials)))>;
+};
+
+/* The modular polynomial of GF(p^m), p > 2 is searched for on first use. */
+template <long prime, long power> struct default_polynomial {
+  using type = ::math::modular_polynomial<0>;
+};
+
+template <long power> struct default_polynomial<2, power> {
+  using type = typename default_modular_polynomial<power>::type;
+};
 }
 
+/* Fields of odd characteristic are defined in math/prime_field.h */
 template <long prime, long power,
           typename Modular_Polynomial =
-              typename detail::default_modular_polynomial<power>::type>
-class ef_element {
-  static constexpr size_t size = (1 << power);
-  static constexpr unsigned mod_polynomial = Modular_Polynomial::value;
-  /* number of non-zero elements in the field */
-  static constexpr size_t n = size - 1;
-  using storage_type = typename detail::uint_t<power>::type;
-};
-
-template <typename GF>
-static constexpr std::pair<typename GF::Exp_table_type,
-                           typename GF::Log_table_type>
-init_tables(const long dimension, const unsigned long size,
-            const uint16_t modular_polynomial);
+              typename detail::default_polynomial<prime, power>::type,
+          typename Arithmetic =
+              typename detail::default_arithmetic<power, prime>::type>
+class ef_element;
 
-template <long Power, typename Modular_Polynomial>
-class ef_element<2, Power, Modular_Polynomial> {
+template <long Power, typename Modular_Polynomial, typename Arithmetic>
+class ef_element<2, Power, Modular_Polynomial, Arithmetic> {
   static constexpr size_t size = (1 << Power);
   /* number of non-zero elements in the field */
   static constexpr size_t n = size - 1;
@@ -103,46 +284,92 @@ class ef_element<2, Power, Modular_Polynomial> {
   static_assert(
       (Modular_Polynomial::value & ~(size - 1)) <= size,
       "Power-th bit has to be the highest set bit in the modular polynomial.");
+  static_assert(std::is_same<Arithmetic, gf::log_table_tag>::value ||
+                    std::is_same<Arithmetic, gf::clmul_tag>::value,
+                "Arithmetic must be log_table_tag or clmul_tag.");
 
 public:
   using storage_type = typename detail::uint_t<Power>::type;
 
 private:
   using element_type = ef_element;
-  using Log_table_type = std::array<storage_type, 2 * size>;
-  using Exp_table_type = std::array<ef_element, 2 * size>;
+  using Log_table_type = detail::table<storage_type, size>;
+  using Exp_table_type = detail::table<storage_type, 2 * size>;
 
-  static const Log_table_type log;
-  static const Exp_table_type exp;
-
-  template <typename GF>
-  friend constexpr std::pair<typename GF::Exp_table_type,
-                             typename GF::Log_table_type>
-  init_tables(const long dimension, const unsigned long size,
-              const uint16_t modular_polynomial);
+  /* Both tables are computed at compile time and live in read-only data. */
+  static constexpr Log_table_type log =
+      detail::log_table<storage_type, size>(Power, Modular_Polynomial::value);
+  static constexpr Exp_table_type exp =
+      detail::exp_table<storage_type, 2 * size>(Power,
+                                                Modular_Polynomial::value);
 
   struct ef {
-    using const_iterator = typename Exp_table_type::const_iterator;
-    using const_reverse_iterator =
-        typename Exp_table_type::const_reverse_iterator;
+    /* Iterates over the exp table, handing out elements instead of their
+     * storage. */
+    class const_iterator {
+      const storage_type *it;
+
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = ef_element;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const ef_element *;
+      using reference = ef_element;
+
+      constexpr explicit const_iterator(const storage_type *it_) noexcept
+          : it(it_) {}
+      constexpr ef_element operator*() const noexcept {
+        return ef_element(*it, gf::unchecked_tag{});
+      }
+      const_iterator &operator++() noexcept {
+        ++it;
+        return *this;
+      }
+      const_iterator operator++(int) noexcept {
+        const_iterator copy(*this);
+        ++it;
+        return copy;
+      }
+      const_iterator &operator--() noexcept {
+        --it;
+        return *this;
+      }
+      const_iterator operator--(int) noexcept {
+        const_iterator copy(*this);
+        --it;
+        return copy;
+      }
+      constexpr bool operator==(const const_iterator &rhs) const noexcept {
+        return it == rhs.it;
+      }
+      constexpr bool operator!=(const const_iterator &rhs) const noexcept {
+        return it != rhs.it;
+      }
+    };
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
     static constexpr size_t offset = size;
     using element_type = ef_element;
 
-    const_iterator begin() const { return std::begin(exp) + offset; }
-    const_iterator end() const { return std::end(exp); }
-    const_iterator cbegin() const noexcept { return std::cbegin(exp) + offset; }
-    const_iterator cend() const noexcept { return std::cend(exp); }
-    const_reverse_iterator rbegin() const { return std::rbegin(exp); }
-    const_reverse_iterator rend() const { return std::rend(exp) - offset; }
+    const_iterator begin() const { return cbegin(); }
+    const_iterator end() const { return cend(); }
+    const_iterator cbegin() const noexcept {
+      return const_iterator(std::begin(exp) + offset);
+    }
+    const_iterator cend() const noexcept {
+      return const_iterator(std::end(exp));
+    }
+    const_reverse_iterator rbegin() const { return crbegin(); }
+    const_reverse_iterator rend() const { return crend(); }
     const_reverse_iterator crbegin() const noexcept {
-      return std::crbegin(exp);
+      return const_reverse_iterator(cend());
     }
     const_reverse_iterator crend() const noexcept {
-      return std::crend(exp) - offset;
+      return const_reverse_iterator(cbegin());
     }
     friend std::ostream &operator<<(std::ostream &os, const ef &ef) {
       for (const auto &e : exp) {
-        os << e << "(" << static_cast<unsigned>(e.value) << ")" << std::endl;
+        const ef_element element(e, gf::unchecked_tag{});
+        os << element << "(" << static_cast<unsigned>(e) << ")" << std::endl;
       }
       for (const auto &e : ef) {
         os << e << "(" << static_cast<unsigned>(e.value) << ")" << std::endl;
@@ -154,73 +381,107 @@ private:
   friend ef;
   storage_type value = 0;
 
+  /* all ones, if v is non-zero */
+  static constexpr storage_type mask(const storage_type v) noexcept {
+    return static_cast<storage_type>(0 - static_cast<storage_type>(v != 0));
+  }
+
+  ef_element multiply(const ef_element &rhs, gf::log_table_tag) const
+      noexcept {
+    const storage_type product = exp[log[value] + log[rhs.value]];
+    return ef_element(
+        static_cast<storage_type>(product & mask(value) & mask(rhs.value)),
+        gf::unchecked_tag{});
+  }
+
+  ef_element multiply(const ef_element &rhs, gf::clmul_tag) const noexcept {
+    const uint64_t product = detail::clmul<Power>(value, rhs.value);
+    return ef_element(static_cast<storage_type>(
+                          detail::reduce<Power, Modular_Polynomial::value>(
+                              product)),
+                      gf::unchecked_tag{});
+  }
+
+  ef_element divide(const ef_element &rhs, gf::log_table_tag) const noexcept {
+    const storage_type quotient = exp[log[value] + n - log[rhs.value]];
+    return ef_element(static_cast<storage_type>(quotient & mask(value)),
+                      gf::unchecked_tag{});
+  }
+
+  /* exp(n - log(rhs)) is the inverse of rhs; a zero dividend is taken care of
+   * by the multiplication. */
+  ef_element divide(const ef_element &rhs, gf::clmul_tag) const noexcept {
+    return multiply(ef_element(exp[n - log[rhs.value]], gf::unchecked_tag{}),
+                    gf::clmul_tag{});
+  }
+
 public:
   using field_type = ef;
   static constexpr size_t digits = Power;
 
   ef_element() = default;
+  /* Validates v; use this constructor for values from outside the field. */
   constexpr explicit ef_element(const storage_type &v) : value(v) {
     if (value & ~n)
       throw std::runtime_error("Value is not an element of the field.");
   }
-  template <typename Mp>
-  constexpr explicit ef_element(const ef_element<2, 1, Mp> &e)
+  /* For values known to be elements of the field, i.e. from arithmetic. */
+  constexpr ef_element(const storage_type &v, gf::unchecked_tag) noexcept
+      : value(v) {}
+  template <typename Mp, typename A>
+  constexpr explicit ef_element(const ef_element<2, 1, Mp, A> &e)
       : value(e ? 1 : 0) {}
   /* TODO(hannes): add parial specialization for Power = 1 */
-  template <long Power_, typename Mp,
+  template <long Power_, typename Mp, typename A,
             typename std::enable_if<(Power_ == Power_) &&
                                     (Power == 1)>::type * = nullptr>
-  constexpr explicit ef_element(const ef_element<2, Power_, Mp> &e)
+  constexpr explicit ef_element(const ef_element<2, Power_, Mp, A> &e)
       : value(e ? 1 : 0) {
-    using gef_type = ef_element<2, Power_, Mp>;
+    using gef_type = ef_element<2, Power_, Mp, A>;
     /* NOTE(hannes): The value from the extension field has to be one or zero to
      * be representable in the 'base' galois field
      */
     assert(e == gef_type(0) || e == gef_type(1));
   }
 
-  static constexpr ef_element from_power(unsigned power) {
-    return exp.at(power % size);
+  static constexpr ef_element from_power(unsigned power) noexcept {
+    return ef_element(exp[power % n], gf::unchecked_tag{});
   }
 
-  unsigned power() const { return log.at(value); }
+  unsigned power() const noexcept { return log[value]; }
 
-  ef_element operator+(const ef_element &rhs) const {
-    return ef_element(value ^ rhs.value);
+  ef_element operator+(const ef_element &rhs) const noexcept {
+    return ef_element(static_cast<storage_type>(value ^ rhs.value),
+                      gf::unchecked_tag{});
   }
 
-  ef_element operator-(const ef_element &rhs) const { return *this + rhs; }
-
-  ef_element operator*(const ef_element &rhs) const {
-    if (value == 0 || rhs.value == 0)
-      return ef_element(0);
-    return ef_element(exp.at(power() + rhs.power()));
+  ef_element operator-(const ef_element &rhs) const noexcept {
+    return *this + rhs;
   }
 
-  ef_element operator/(const ef_element &rhs) const {
-    if (rhs.value == 0)
-      throw std::overflow_error("Divide by zero exception");
-
-    if (value == 0)
-      return ef_element(0);
+  ef_element operator*(const ef_element &rhs) const noexcept {
+    return multiply(rhs, Arithmetic{});
+  }
 
-    return exp.at(static_cast<size_t>(power()) -
-                  static_cast<size_t>(rhs.power()) + size - 1);
+  /* Division by zero is a precondition violation. */
+  ef_element operator/(const ef_element &rhs) const noexcept {
+    assert(rhs.value != 0);
+    return divide(rhs, Arithmetic{});
   }
-  ef_element inverse() const { return ef_element(1) / *this; }
+  ef_element inverse() const noexcept { return ef_element(1) / *this; }
 
-  ef_element &operator*=(const ef_element &rhs) {
+  ef_element &operator*=(const ef_element &rhs) noexcept {
     *this = *this * rhs;
     return *this;
   }
 
-  ef_element &operator+=(const ef_element &rhs) {
+  ef_element &operator+=(const ef_element &rhs) noexcept {
     *this = *this + rhs;
     return *this;
   }
 
-  ef_element &operator++() {
-    *this = *this + ef_element(1);
+  ef_element &operator++() noexcept {
+    *this = *this + ef_element(1, gf::unchecked_tag{});
     /*
     if (value == 0) {
       value = 1;
@@ -231,13 +492,13 @@ public:
     return *this;
   }
 
-  ef_element operator++(int) {
+  ef_element operator++(int) noexcept {
     ef_element result(*this);
     ++(*this);
     return result;
   }
 
-  bool operator<(const ef_element &rhs) const {
+  bool operator<(const ef_element &rhs) const noexcept {
     /* x < 0 is false */
     if (!rhs.value)
       return false;
@@ -247,16 +508,20 @@ public:
     /* sort by power */
     return power() < rhs.power();
   }
-  bool operator!=(const ef_element &rhs) const { return value != rhs.value; }
-  bool operator==(const ef_element &rhs) const { return value == rhs.value; }
+  bool operator!=(const ef_element &rhs) const noexcept {
+    return value != rhs.value;
+  }
+  bool operator==(const ef_element &rhs) const noexcept {
+    return value == rhs.value;
+  }
 
-  explicit operator bool() const { return value != 0; }
-  explicit operator storage_type() const { return value; }
-  explicit operator unsigned() const { return value; }
-  explicit operator unsigned long() const { return value; }
-  explicit operator unsigned long long() const { return value; }
-  explicit operator int() const { return value; }
-  explicit operator float() const { return value; }
+  explicit operator bool() const noexcept { return value != 0; }
+  explicit operator storage_type() const noexcept { return value; }
+  explicit operator unsigned() const noexcept { return value; }
+  explicit operator unsigned long() const noexcept { return value; }
+  explicit operator unsigned long long() const noexcept { return value; }
+  explicit operator int() const noexcept { return value; }
+  explicit operator float() const noexcept { return value; }
 
   friend std::ostream &operator<<(std::ostream &os, const ef_element &e) {
     if (e.value == 0)
@@ -266,55 +531,15 @@ public:
   }
 };
 
-template <typename GF>
-static constexpr std::pair<typename GF::Exp_table_type,
-                           typename GF::Log_table_type>
-init_tables(const long dimension, const unsigned long size,
-            const uint16_t modular_polynomial) {
-  using storage_type = typename GF::storage_type;
-  using element_type = typename GF::element_type;
-
-  typename GF::Exp_table_type exp;
-  typename GF::Log_table_type log;
-
-  storage_type polynomial = 1;
-  for (storage_type power = 0; power < size - 1; power++) {
-    log.at(polynomial) = power;
-    log.at(polynomial + size) = power;
-
-    exp.at(power) = element_type(polynomial);
-    exp.at(power + size - 1) = element_type(polynomial);
-
-    bool carry = polynomial & (1 << (dimension - 1));
-    polynomial <<= 1;
-    if (carry)
-      polynomial ^= modular_polynomial;
-  }
-
-  log.at(0) = 0;
-  log.at(size) = 0;
-
-  exp.at(size - 1) = element_type(1);
-  exp.at(2 *size - 2) = element_type(1);
-
-  return std::make_pair(exp, log);
-}
+template <long Power, typename Mp, typename A>
+constexpr typename ef_element<2, Power, Mp, A>::Log_table_type
+    ef_element<2, Power, Mp, A>::log;
 
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wglobal-constructors"
-template <long Power, typename Mp>
-const typename ef_element<2, Power, Mp>::Log_table_type
-ef_element<2, Power, Mp>::log =
-    init_tables<ef_element<2, Power, Mp> >(Power,
-                                           ef_element<2, Power, Mp>::size,
-                                           Mp::value).second;
-
-template <long Power, typename Mp>
-const typename ef_element<2, Power, Mp>::Exp_table_type
-ef_element<2, Power, Mp>::exp =
-    init_tables<ef_element<2, Power, Mp> >(Power,
-                                           ef_element<2, Power, Mp>::size,
-                                           Mp::value).first;
-#pragma clang diagnostic pop
+template <long Power, typename Mp, typename A>
+constexpr typename ef_element<2, Power, Mp, A>::Exp_table_type
+    ef_element<2, Power, Mp, A>::exp;
 }
 
+/* tower fields need the complete definition of the smaller fields */
+#include "math/tower.h"
+#include "math/prime_field.h"
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "math/kernels.h"
+#include "math/matrix.h"
+
+namespace math {
+
+/* A rows x columns matrix over a field in one row-major buffer, brought into
+ * reduced row echelon form in place by Gauss-Jordan elimination. Every row
+ * operation is one scale or axpy kernel over the remainder of a row.
+ *
+ * Pivoting picks the first non-zero element of a column: in a finite field
+ * every non-zero pivot is exact, so there is nothing to gain from the largest.
+ *
+ * Container may be a math::static_vector to avoid dynamic memory allocation.
+ */
+template <typename Element, typename Container = std::vector<Element> >
+class dense_system {
+  Container elements;
+  size_t rows_;
+  size_t columns_;
+  size_t rank_ = 0;
+  Element determinant_ = Element(0);
+
+public:
+  dense_system(const size_t rows, const size_t columns)
+      : elements(rows * columns, Element(0)), rows_(rows), columns_(columns) {}
+
+  size_t rows() const noexcept { return rows_; }
+  size_t columns() const noexcept { return columns_; }
+
+  Element *operator[](const size_t row) noexcept {
+    return elements.data() + row * columns_;
+  }
+  const Element *operator[](const size_t row) const noexcept {
+    return elements.data() + row * columns_;
+  }
+
+  /* Reduce the first unknowns columns; the remaining columns, e.g. right-hand
+   * sides, are transformed along. Returns the rank. */
+  size_t eliminate(const size_t unknowns) {
+    rank_ = 0;
+    determinant_ = Element(1);
+    for (size_t column = 0; column < unknowns && rank_ < rows_; column++) {
+      size_t pivot = rank_;
+      while (pivot < rows_ && !(*this)[pivot][column])
+        pivot++;
+      if (pivot == rows_)
+        continue;
+
+      Element *row = (*this)[rank_];
+      if (pivot != rank_) {
+        std::swap_ranges(row, row + columns_, (*this)[pivot]);
+        determinant_ = Element(0) - determinant_;
+      }
+
+      determinant_ = determinant_ * row[column];
+      kernel::scale(row + column, row + columns_, row[column].inverse());
+      for (size_t i = 0; i < rows_; i++) {
+        Element *other = (*this)[i];
+        if (i != rank_ && other[column])
+          kernel::axpy(other + column, other + columns_, row + column,
+                       Element(0) - other[column]);
+      }
+      rank_++;
+    }
+
+    if (rank_ < unknowns)
+      determinant_ = Element(0);
+    return rank_;
+  }
+
+  size_t eliminate() { return eliminate(columns_); }
+
+  size_t rank() const noexcept { return rank_; }
+
+  /* Determinant of the leading square matrix after eliminate(rows()) */
+  const Element &determinant() const noexcept { return determinant_; }
+
+  /* Column of the pivot of a row below rank() after eliminate() */
+  size_t pivot(const size_t row) const {
+    const Element *first = (*this)[row];
+    return static_cast<size_t>(
+        std::find_if(first, first + columns_,
+                     [](const Element &e) { return bool(e); }) -
+        first);
+  }
+};
+
+/* A gf2_matrix brought into reduced row echelon form by the Method of Four
+ * Russians (M4RI, G. Bard):
+ *
+ * Up to block pivots are found by ordinary elimination among the remaining
+ * rows. All 2^block sums of the pivot rows are tabulated, one row addition per
+ * entry, after which the pivot columns of every other row are cleared by a
+ * single addition of the table entry its pivot column bits select. That is
+ * one row addition per row and block instead of one per row and pivot.
+ */
+class gf2_system : public gf2_matrix {
+  static constexpr size_t block = 8;
+
+  std::vector<uint64_t> table;
+  size_t rank_ = 0;
+
+  static bool bit(const uint64_t *row, const size_t column) noexcept {
+    return (row[column / word_bits] >> (column % word_bits)) & 1;
+  }
+
+  /* row[first, words()) ^= other[first, words()) */
+  void add(uint64_t *row, const uint64_t *other, const size_t first) const
+      noexcept {
+    for (size_t word = first; word < words(); word++)
+      row[word] ^= other[word];
+  }
+
+  /* row[first, words()) ^= entry[0, words() - first) */
+  void add_entry(uint64_t *row, const uint64_t *entry, const size_t first) const
+      noexcept {
+    for (size_t word = first; word < words(); word++)
+      row[word] ^= entry[word - first];
+  }
+
+public:
+  gf2_system(const size_t rows, const size_t columns)
+      : gf2_matrix(rows, columns) {}
+  explicit gf2_system(gf2_matrix matrix) : gf2_matrix(std::move(matrix)) {}
+
+  /* Reduce the first unknowns columns; the remaining columns are transformed
+   * along. Returns the rank. */
+  size_t eliminate(const size_t unknowns) {
+    const size_t height = rows();
+    const size_t stride = words();
+    size_t pivots[block];
+    size_t column = 0;
+    rank_ = 0;
+
+    while (column < unknowns && rank_ < height) {
+      /* the pivot rows of a block are reduced with respect to each other */
+      size_t found = 0;
+      for (; column < unknowns && found < block && rank_ + found < height;
+           column++) {
+        size_t pivot = rank_ + found;
+        for (; pivot < height; pivot++) {
+          uint64_t *row = (*this)[pivot];
+          for (size_t j = 0; j < found; j++) {
+            if (bit(row, pivots[j]))
+              add(row, (*this)[rank_ + j], pivots[j] / word_bits);
+          }
+          if (bit(row, column))
+            break;
+        }
+        if (pivot == height)
+          continue;
+
+        uint64_t *row = (*this)[rank_ + found];
+        if (pivot != rank_ + found)
+          std::swap_ranges(row, row + stride, (*this)[pivot]);
+        for (size_t j = 0; j < found; j++) {
+          uint64_t *previous = (*this)[rank_ + j];
+          if (bit(previous, column))
+            add(previous, row, column / word_bits);
+        }
+        pivots[found++] = column;
+      }
+
+      if (!found)
+        break;
+
+      /* entry x is the sum of the pivot rows j with bit j of x set. Rows at
+       * and below rank_ are zero left of the first pivot. */
+      const size_t first = pivots[0] / word_bits;
+      const size_t width = stride - first;
+      const size_t entries = size_t(1) << found;
+      table.assign(entries * width, 0);
+      for (size_t x = 1; x < entries; x++) {
+        const auto j = static_cast<size_t>(__builtin_ctzll(x));
+        const uint64_t *previous = table.data() + (x & (x - 1)) * width;
+        const uint64_t *pivot_row = (*this)[rank_ + j] + first;
+        uint64_t *entry = table.data() + x * width;
+        for (size_t word = 0; word < width; word++)
+          entry[word] = previous[word] ^ pivot_row[word];
+      }
+
+      for (size_t i = 0; i < height; i++) {
+        if (i >= rank_ && i < rank_ + found)
+          continue;
+        uint64_t *row = (*this)[i];
+        size_t x = 0;
+        for (size_t j = 0; j < found; j++)
+          x |= size_t(bit(row, pivots[j])) << j;
+        if (x)
+          add_entry(row, table.data() + x * width, first);
+      }
+
+      rank_ += found;
+    }
+
+    return rank_;
+  }
+
+  size_t eliminate() { return eliminate(columns()); }
+
+  size_t rank() const noexcept { return rank_; }
+
+  /* Column of the pivot of a row below rank() after eliminate() */
+  size_t pivot(const size_t row) const noexcept {
+    const uint64_t *words_ = (*this)[row];
+    for (size_t word = 0; word < words(); word++) {
+      if (words_[word])
+        return word * word_bits +
+               static_cast<size_t>(__builtin_ctzll(words_[word]));
+    }
+    return columns();
+  }
+};
+}
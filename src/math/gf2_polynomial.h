@@ -0,0 +1,330 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef __PCLMUL__
+#include <wmmintrin.h>
+#endif
+
+#include "math/static_vector.h"
+
+namespace math {
+namespace detail {
+/* Carry-less product of two 64 bit polynomials as { low, high } word. */
+inline std::pair<uint64_t, uint64_t> clmul64(const uint64_t a,
+                                             const uint64_t b) {
+#ifdef __PCLMUL__
+  const __m128i product = _mm_clmulepi64_si128(
+      _mm_cvtsi64_si128(static_cast<long long>(a)),
+      _mm_cvtsi64_si128(static_cast<long long>(b)), 0x00);
+  return std::make_pair(
+      static_cast<uint64_t>(_mm_cvtsi128_si64(product)),
+      static_cast<uint64_t>(
+          _mm_cvtsi128_si64(_mm_unpackhi_epi64(product, product))));
+#else
+  uint64_t low = 0;
+  uint64_t high = 0;
+  for (unsigned bit = 0; bit < 64; bit++) {
+    const uint64_t mask = 0 - ((b >> bit) & 1);
+    low ^= (a << bit) & mask;
+    if (bit)
+      high ^= (a >> (64 - bit)) & mask;
+  }
+  return std::make_pair(low, high);
+#endif
+}
+
+/* floor(x^128 / (x^64 + g)) - x^64 */
+inline uint64_t barrett_constant64(const uint64_t g) {
+  uint64_t remainder = g;
+  uint64_t quotient = 0;
+  for (unsigned bit = 64; bit--;) {
+    if ((remainder >> bit) & 1) {
+      quotient |= uint64_t(1) << bit;
+      if (bit)
+        remainder ^= g >> (64 - bit);
+    }
+  }
+  return quotient;
+}
+}
+
+/* Polynomials over GF(2) with 64 coefficients per word. Coefficient i is bit
+ * i % 64 of word i / 64. Bits beyond size() are always zero.
+ *
+ * Division reduces 64 coefficients at a time: the quotient of the 64 highest
+ * coefficients of the dividend by the 65 highest coefficients of the divisor is
+ * computed with one carry-less multiplication (Barrett reduction), and the
+ * product of quotient and divisor is subtracted with one carry-less
+ * multiplication per word of the divisor.
+ */
+template <typename Container = std::vector<uint64_t> > class gf2_polynomial {
+  template <typename> friend class gf2_polynomial;
+
+  static constexpr size_t word_bits = 64;
+
+  Container words;
+  size_t size_ = 0;
+
+  static size_t words_for(const size_t bits) {
+    return (bits + word_bits - 1) / word_bits;
+  }
+
+  /* coefficients [position, position + 64), zero outside of the words */
+  uint64_t bits_at(const ssize_t position) const {
+    if (position < 0) {
+      if (position <= -static_cast<ssize_t>(word_bits))
+        return 0;
+      return bits_at(0) << -position;
+    }
+
+    const size_t word = static_cast<size_t>(position) / word_bits;
+    const size_t shift = static_cast<size_t>(position) % word_bits;
+    if (word >= words.size())
+      return 0;
+    uint64_t bits = words[word] >> shift;
+    if (shift && word + 1 < words.size())
+      bits |= words[word + 1] << (word_bits - shift);
+    return bits;
+  }
+
+  /* coefficients [position, position + 64) ^= bits */
+  void xor_at(const size_t position, const uint64_t bits) {
+    const size_t word = position / word_bits;
+    const size_t shift = position % word_bits;
+    if (word < words.size())
+      words[word] ^= bits << shift;
+    if (shift && word + 1 < words.size())
+      words[word + 1] ^= bits >> (word_bits - shift);
+  }
+
+  void clear_tail() {
+    if (size_ % word_bits)
+      words.back() &= (uint64_t(1) << (size_ % word_bits)) - 1;
+  }
+
+  /* r = r mod g, q = r div g if q is given */
+  template <typename Divisor>
+  static void reduce(gf2_polynomial &r, const gf2_polynomial<Divisor> &g,
+                     gf2_polynomial *q) {
+    const ssize_t k = g.degree();
+    const uint64_t mu = detail::barrett_constant64(g.bits_at(k - 64));
+    const size_t divisor_words = static_cast<size_t>(k) / word_bits + 1;
+
+    for (ssize_t high = r.degree(); high >= k;) {
+      const ssize_t s =
+          std::min(static_cast<ssize_t>(word_bits), high - k + 1);
+      const uint64_t top = r.bits_at(high - 63);
+      const uint64_t quotient =
+          (top ^ detail::clmul64(top, mu).second) >> (64 - s);
+      const size_t offset = static_cast<size_t>(high - k - s + 1);
+
+      if (quotient) {
+        if (q)
+          q->xor_at(offset, quotient);
+        for (size_t word = 0; word < divisor_words; word++) {
+          const auto product = detail::clmul64(quotient, g.words[word]);
+          r.xor_at(offset + word * word_bits, product.first);
+          r.xor_at(offset + (word + 1) * word_bits, product.second);
+        }
+      }
+      high -= s;
+    }
+  }
+
+public:
+  using size_type = size_t;
+
+  gf2_polynomial() = default;
+  /* the zero polynomial with size coefficients */
+  explicit gf2_polynomial(const size_t size)
+      : words(words_for(size), 0), size_(size) {}
+  /* coefficients from a range of values convertible to bool */
+  template <typename InputIt,
+            typename = typename std::iterator_traits<InputIt>::value_type>
+  gf2_polynomial(InputIt first, InputIt last) {
+    for (; first != last; ++first)
+      push_back(bool(*first));
+  }
+
+  size_t size() const noexcept { return size_; }
+
+  void resize(const size_t size) {
+    words.resize(words_for(size), 0);
+    size_ = size;
+    clear_tail();
+  }
+
+  void push_back(const bool bit) {
+    if (size_ % word_bits == 0)
+      words.push_back(0);
+    words.back() |= uint64_t(bit) << (size_ % word_bits);
+    size_++;
+  }
+
+  bool operator[](const size_t i) const {
+    return (words[i / word_bits] >> (i % word_bits)) & 1;
+  }
+
+  void set(const size_t i, const bool bit) {
+    const uint64_t mask = uint64_t(1) << (i % word_bits);
+    words.at(i / word_bits) =
+        (words[i / word_bits] & ~mask) | ((0 - uint64_t(bit)) & mask);
+  }
+
+  void flip(const size_t i) {
+    words.at(i / word_bits) ^= uint64_t(1) << (i % word_bits);
+  }
+
+  uint64_t *data() noexcept { return words.data(); }
+  const uint64_t *data() const noexcept { return words.data(); }
+
+  ssize_t degree() const noexcept {
+    for (size_t word = words.size(); word--;) {
+      if (words[word])
+        return static_cast<ssize_t>(word * word_bits + word_bits - 1) -
+               __builtin_clzll(words[word]);
+    }
+    return -1;
+  }
+
+  size_t weight() const noexcept {
+    size_t weight = 0;
+    for (const auto &word : words)
+      weight += static_cast<size_t>(__builtin_popcountll(word));
+    return weight;
+  }
+
+  /* returns true for non-empty, non-zero polynomials */
+  explicit operator bool() const noexcept {
+    return std::any_of(std::cbegin(words), std::cend(words),
+                       [](const uint64_t word) { return word != 0; });
+  }
+
+  gf2_polynomial &operator+=(const gf2_polynomial &rhs) {
+    if (size_ < rhs.size_)
+      resize(rhs.size_);
+    std::transform(std::cbegin(rhs.words), std::cend(rhs.words),
+                   std::cbegin(words), std::begin(words),
+                   [](const uint64_t a, const uint64_t b) { return a ^ b; });
+    return *this;
+  }
+
+  gf2_polynomial &operator-=(const gf2_polynomial &rhs) { return *this += rhs; }
+
+  gf2_polynomial operator+(const gf2_polynomial &rhs) const {
+    auto copy(*this);
+    copy += rhs;
+    return copy;
+  }
+
+  gf2_polynomial operator-(const gf2_polynomial &rhs) const {
+    return *this + rhs;
+  }
+
+  /* multiplication by x^n */
+  gf2_polynomial operator<<(const size_t n) const {
+    gf2_polynomial result(size_ + n);
+    for (size_t word = 0; word < words.size(); word++)
+      result.xor_at(n + word * word_bits, words[word]);
+    return result;
+  }
+
+  /* division by x^n */
+  gf2_polynomial operator>>(const size_t n) const {
+    gf2_polynomial result(size_ > n ? size_ - n : 0);
+    for (size_t word = 0; word < result.words.size(); word++)
+      result.words[word] =
+          bits_at(static_cast<ssize_t>(n + word * word_bits));
+    result.clear_tail();
+    return result;
+  }
+
+  gf2_polynomial operator*(const gf2_polynomial &rhs) const {
+    const ssize_t lhs_degree = degree();
+    const ssize_t rhs_degree = rhs.degree();
+    if (lhs_degree < 0 || rhs_degree < 0)
+      return gf2_polynomial(1);
+
+    gf2_polynomial result(static_cast<size_t>(lhs_degree + rhs_degree) + 1);
+    const size_t lhs_words = static_cast<size_t>(lhs_degree) / word_bits + 1;
+    const size_t rhs_words = static_cast<size_t>(rhs_degree) / word_bits + 1;
+    for (size_t i = 0; i < lhs_words; i++) {
+      for (size_t j = 0; j < rhs_words; j++) {
+        const auto product = detail::clmul64(words[i], rhs.words[j]);
+        result.xor_at((i + j) * word_bits, product.first);
+        result.xor_at((i + j + 1) * word_bits, product.second);
+      }
+    }
+    return result;
+  }
+
+  gf2_polynomial &operator*=(const gf2_polynomial &rhs) {
+    *this = *this * rhs;
+    return *this;
+  }
+
+  /* return quotient and remainder; the divisor may use another container */
+  template <typename Divisor>
+  std::pair<gf2_polynomial, gf2_polynomial>
+  division(const gf2_polynomial<Divisor> &rhs) const {
+    const ssize_t k = rhs.degree();
+    if (k < 0)
+      throw std::logic_error("Division by zero");
+
+    const ssize_t d = degree();
+    if (d < k)
+      return std::make_pair(gf2_polynomial(1), *this);
+
+    gf2_polynomial q(static_cast<size_t>(d - k) + 1);
+    gf2_polynomial r(*this);
+    reduce(r, rhs, &q);
+    r.resize(static_cast<size_t>(k));
+    return std::make_pair(q, r);
+  }
+
+  template <typename Divisor>
+  gf2_polynomial operator/(const gf2_polynomial<Divisor> &rhs) const {
+    return division(rhs).first;
+  }
+
+  /* the remainder only, without the quotient */
+  template <typename Divisor>
+  gf2_polynomial operator%(const gf2_polynomial<Divisor> &rhs) const {
+    const ssize_t k = rhs.degree();
+    if (k < 0)
+      throw std::logic_error("Division by zero");
+
+    gf2_polynomial r(*this);
+    reduce(r, rhs, nullptr);
+    if (r.size_ > static_cast<size_t>(k))
+      r.resize(static_cast<size_t>(k));
+    return r;
+  }
+
+  bool operator==(const gf2_polynomial &rhs) const {
+    return size_ == rhs.size_ && words == rhs.words;
+  }
+  bool operator!=(const gf2_polynomial &rhs) const { return !(*this == rhs); }
+
+  /* coefficients, lowest degree first */
+  friend std::ostream &operator<<(std::ostream &s,
+                                  const gf2_polynomial &polynomial) {
+    for (size_t i = 0; i < polynomial.size(); i++)
+      s << polynomial[i];
+    return s;
+  }
+};
+
+/* Polynomials up to degree MaxDegree without dynamic memory allocation. */
+template <size_t MaxDegree>
+using static_gf2_polynomial =
+    gf2_polynomial<static_vector<uint64_t, MaxDegree / 64 + 1> >;
+}
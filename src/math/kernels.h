@@ -0,0 +1,513 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <algorithm>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+#include "math/galois.h"
+#include "math/static_vector.h"
+
+/* Kernels over contiguous arrays of field elements.
+ *
+ * Multiplication by a constant c is linear in GF(2^m), so c * x is the sum of
+ * the products of c with each nibble of x. The products of c with all 16
+ * values of every nibble are tabulated once, after which a product costs one
+ * table lookup per nibble. Vector units perform 16 or 32 of those lookups at a
+ * time with PSHUFB. Fields up to GF(2^8) need two tables, fields up to
+ * GF(2^16) eight (four nibbles with two result bytes each).
+ *
+ * The generic versions only require the usual arithmetic operators and are
+ * used for all other coefficient types.
+ */
+
+namespace math {
+namespace kernel {
+
+namespace detail {
+template <typename Element> struct is_split_table_field : std::false_type {};
+
+template <long Power, typename Mp, typename A>
+struct is_split_table_field<ef_element<2, Power, Mp, A> >
+    : std::integral_constant<bool, (Power <= 16)> {};
+
+/* Building the tables costs about as much as this many multiplications */
+static constexpr size_t split_table_threshold = 32;
+
+/* Products of operands shorter than this are computed by schoolbook
+ * multiplication. The split tables make long axpy spans so fast, that
+ * Karatsuba only pays off for very long operands. */
+static constexpr size_t karatsuba_threshold = 1024;
+static_assert(karatsuba_threshold > 1, "Karatsuba needs at least two terms.");
+
+#if defined(__AVX2__)
+struct simd {
+  using type = __m256i;
+  static constexpr size_t bytes = 32;
+
+  static type load(const void *p) {
+    return _mm256_loadu_si256(static_cast<const type *>(p));
+  }
+  static void store(void *p, const type &v) {
+    _mm256_storeu_si256(static_cast<type *>(p), v);
+  }
+  static type table(const uint8_t *p) {
+    return _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i *>(p)));
+  }
+  static type lookup(const type &table, const type &index) {
+    return _mm256_shuffle_epi8(table, index);
+  }
+  static type nibble_mask() { return _mm256_set1_epi8(0x0f); }
+  static type byte_mask() { return _mm256_set1_epi16(0x00ff); }
+  static type and_(const type &a, const type &b) {
+    return _mm256_and_si256(a, b);
+  }
+  static type xor_(const type &a, const type &b) {
+    return _mm256_xor_si256(a, b);
+  }
+  template <int bits> static type shift_right(const type &v) {
+    return _mm256_srli_epi16(v, bits);
+  }
+  static type pack(const type &a, const type &b) {
+    return _mm256_packus_epi16(a, b);
+  }
+  static type unpack_low(const type &a, const type &b) {
+    return _mm256_unpacklo_epi8(a, b);
+  }
+  static type unpack_high(const type &a, const type &b) {
+    return _mm256_unpackhi_epi8(a, b);
+  }
+};
+#elif defined(__SSSE3__)
+struct simd {
+  using type = __m128i;
+  static constexpr size_t bytes = 16;
+
+  static type load(const void *p) {
+    return _mm_loadu_si128(static_cast<const type *>(p));
+  }
+  static void store(void *p, const type &v) {
+    _mm_storeu_si128(static_cast<type *>(p), v);
+  }
+  static type table(const uint8_t *p) {
+    return _mm_load_si128(reinterpret_cast<const type *>(p));
+  }
+  static type lookup(const type &table, const type &index) {
+    return _mm_shuffle_epi8(table, index);
+  }
+  static type nibble_mask() { return _mm_set1_epi8(0x0f); }
+  static type byte_mask() { return _mm_set1_epi16(0x00ff); }
+  static type and_(const type &a, const type &b) { return _mm_and_si128(a, b); }
+  static type xor_(const type &a, const type &b) { return _mm_xor_si128(a, b); }
+  template <int bits> static type shift_right(const type &v) {
+    return _mm_srli_epi16(v, bits);
+  }
+  static type pack(const type &a, const type &b) {
+    return _mm_packus_epi16(a, b);
+  }
+  static type unpack_low(const type &a, const type &b) {
+    return _mm_unpacklo_epi8(a, b);
+  }
+  static type unpack_high(const type &a, const type &b) {
+    return _mm_unpackhi_epi8(a, b);
+  }
+};
+#endif
+}
+
+/* Multiplication by the constant c */
+template <typename Element,
+          bool = detail::is_split_table_field<Element>::value>
+class multiplier {
+  Element c;
+
+public:
+  explicit multiplier(const Element &c_) : c(c_) {}
+
+  Element operator()(const Element &x) const { return x * c; }
+
+  /* [first, last) *= c */
+  void scale(Element *first, Element *last) const {
+    for (; first != last; ++first)
+      *first = *first * c;
+  }
+
+  /* [first, last) += c * src */
+  void axpy(Element *first, Element *last, const Element *src) const {
+    for (; first != last; ++first, ++src)
+      *first = *first + *src * c;
+  }
+};
+
+template <typename Element> class multiplier<Element, true> {
+  using storage_type = typename Element::storage_type;
+  static constexpr size_t bytes = sizeof(storage_type);
+  static constexpr size_t nibbles = 2 * bytes;
+
+  static_assert(bytes <= 2, "Split tables are implemented for up to 16 bits.");
+  static_assert(sizeof(Element) == sizeof(storage_type),
+                "Elements have to be accessible as their storage_type.");
+
+  /* tables[nibble][byte][value] is the byte-th byte of the product of c and
+   * value << (4 * nibble) */
+  alignas(16) uint8_t tables[nibbles][bytes][16];
+  Element c;
+
+  storage_type product(const storage_type x) const {
+    storage_type result = 0;
+    for (size_t nibble = 0; nibble < nibbles; nibble++) {
+      const auto value = (x >> (4 * nibble)) & 0xf;
+      for (size_t byte = 0; byte < bytes; byte++)
+        result ^= static_cast<storage_type>(tables[nibble][byte][value]
+                                            << (8 * byte));
+    }
+    return result;
+  }
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+  using simd = detail::simd;
+  using vector = typename simd::type;
+
+  /* PSHUFB works on bytes. Elements, which are one byte wide, are looked up
+   * directly. */
+  template <bool accumulate>
+  size_t apply_vector(uint8_t *dst, const uint8_t *src, const size_t count,
+                      std::integral_constant<size_t, 1>) const {
+    const vector mask = simd::nibble_mask();
+    const vector low = simd::table(tables[0][0]);
+    const vector high = simd::table(tables[1][0]);
+
+    size_t i = 0;
+    for (; i + simd::bytes <= count; i += simd::bytes) {
+      const vector x = simd::load(src + i);
+      vector p = simd::xor_(
+          simd::lookup(low, simd::and_(x, mask)),
+          simd::lookup(high, simd::and_(simd::shift_right<4>(x), mask)));
+      if (accumulate)
+        p = simd::xor_(p, simd::load(dst + i));
+      simd::store(dst + i, p);
+    }
+    return i;
+  }
+
+  /* Two byte wide elements are split into a vector of low and a vector of high
+   * bytes first. The product is computed bytewise and interleaved again. */
+  template <bool accumulate>
+  size_t apply_vector(uint16_t *dst, const uint16_t *src, const size_t count,
+                      std::integral_constant<size_t, 2>) const {
+    constexpr size_t lanes = simd::bytes / 2;
+    const vector mask = simd::nibble_mask();
+    const vector byte_mask = simd::byte_mask();
+    vector t[nibbles][bytes];
+    for (size_t nibble = 0; nibble < nibbles; nibble++)
+      for (size_t byte = 0; byte < bytes; byte++)
+        t[nibble][byte] = simd::table(tables[nibble][byte]);
+
+    size_t i = 0;
+    for (; i + 2 * lanes <= count; i += 2 * lanes) {
+      const vector a = simd::load(src + i);
+      const vector b = simd::load(src + i + lanes);
+      const vector low = simd::pack(simd::and_(a, byte_mask),
+                                    simd::and_(b, byte_mask));
+      const vector high =
+          simd::pack(simd::shift_right<8>(a), simd::shift_right<8>(b));
+      const vector n[nibbles] = { simd::and_(low, mask),
+                                  simd::and_(simd::shift_right<4>(low), mask),
+                                  simd::and_(high, mask),
+                                  simd::and_(simd::shift_right<4>(high),
+                                             mask) };
+      vector p[bytes];
+      for (size_t byte = 0; byte < bytes; byte++) {
+        p[byte] = simd::lookup(t[0][byte], n[0]);
+        for (size_t nibble = 1; nibble < nibbles; nibble++)
+          p[byte] = simd::xor_(p[byte], simd::lookup(t[nibble][byte], n[nibble]));
+      }
+
+      vector first = simd::unpack_low(p[0], p[1]);
+      vector second = simd::unpack_high(p[0], p[1]);
+      if (accumulate) {
+        first = simd::xor_(first, simd::load(dst + i));
+        second = simd::xor_(second, simd::load(dst + i + lanes));
+      }
+      simd::store(dst + i, first);
+      simd::store(dst + i + lanes, second);
+    }
+    return i;
+  }
+#endif
+
+  template <bool accumulate>
+  void apply(Element *first, Element *last, const Element *src) const {
+    auto dst_ = reinterpret_cast<storage_type *>(first);
+    auto src_ = reinterpret_cast<const storage_type *>(src);
+    const size_t count = static_cast<size_t>(last - first);
+    size_t i = 0;
+#if defined(__AVX2__) || defined(__SSSE3__)
+    i = apply_vector<accumulate>(dst_, src_, count,
+                                 std::integral_constant<size_t, bytes>{});
+#endif
+    for (; i < count; i++) {
+      const storage_type p = product(src_[i]);
+      dst_[i] = accumulate ? static_cast<storage_type>(dst_[i] ^ p) : p;
+    }
+  }
+
+public:
+  explicit multiplier(const Element &c_) : tables(), c(c_) {
+    for (size_t nibble = 0; nibble * 4 < Element::digits; nibble++) {
+      storage_type products[16] = { 0 };
+      for (size_t bit = 0; bit < 4 && nibble * 4 + bit < Element::digits;
+           bit++) {
+        const Element x(static_cast<storage_type>(1 << (nibble * 4 + bit)),
+                        gf::unchecked_tag{});
+        const auto basis = static_cast<storage_type>(c * x);
+        /* c * value = c * (value without its highest bit) + c * highest bit */
+        for (size_t value = 1 << bit; value < (2u << bit); value++)
+          products[value] =
+              static_cast<storage_type>(products[value ^ (1 << bit)] ^ basis);
+      }
+      for (size_t value = 0; value < 16; value++)
+        for (size_t byte = 0; byte < bytes; byte++)
+          tables[nibble][byte][value] =
+              static_cast<uint8_t>(products[value] >> (8 * byte));
+    }
+  }
+
+  Element operator()(const Element &x) const {
+    return Element(product(static_cast<storage_type>(x)),
+                   gf::unchecked_tag{});
+  }
+
+  void scale(Element *first, Element *last) const {
+    apply<false>(first, last, first);
+  }
+
+  void axpy(Element *first, Element *last, const Element *src) const {
+    apply<true>(first, last, src);
+  }
+};
+
+/* [first, last) *= c */
+template <typename Element>
+void scale(Element *first, Element *last, const Element &c) {
+  if (static_cast<size_t>(last - first) < detail::split_table_threshold)
+    multiplier<Element, false>(c).scale(first, last);
+  else
+    multiplier<Element>(c).scale(first, last);
+}
+
+/* [first, last) += c * [src, src + (last - first)) */
+template <typename Element>
+void axpy(Element *first, Element *last, const Element *src, const Element &c) {
+  if (!c)
+    return;
+  if (static_cast<size_t>(last - first) < detail::split_table_threshold)
+    multiplier<Element, false>(c).axpy(first, last, src);
+  else
+    multiplier<Element>(c).axpy(first, last, src);
+}
+
+/* Σ a_i * b_i. Both factors vary, so there is nothing to tabulate. */
+template <typename Element>
+Element dot(const Element *first1, const Element *last1,
+            const Element *first2) {
+  Element sum(0);
+  for (; first1 != last1; ++first1, ++first2)
+    sum = sum + *first1 * *first2;
+  return sum;
+}
+
+namespace detail {
+/* out[0, na + nb - 1) = a * b, one axpy per coefficient of the shorter
+ * operand, so the spans are as long as possible. */
+template <typename Element>
+void schoolbook(const Element *a, size_t na, const Element *b, size_t nb,
+                Element *out) {
+  if (na < nb) {
+    std::swap(a, b);
+    std::swap(na, nb);
+  }
+  std::fill(out, out + na + nb - 1, Element(0));
+  for (size_t i = 0; i < nb; i++)
+    axpy(out + i, out + i + na, a, b[i]);
+}
+
+inline size_t karatsuba_scratch(const size_t n) {
+  if (n < karatsuba_threshold)
+    return 0;
+  const size_t h = n - n / 2;
+  return 4 * h - 1 + karatsuba_scratch(h);
+}
+
+/* out[0, 2n - 1) = a * b for operands of n terms each:
+ *
+ *   a = a0 + x^m a1, b = b0 + x^m b1
+ *   a * b = z0 + x^m ((a0 + a1) (b0 + b1) - z0 - z2) + x^2m z2
+ *
+ * with z0 = a0 * b0 and z2 = a1 * b1, i.e. three half-size products instead
+ * of four. */
+template <typename Element>
+void karatsuba(const Element *a, const Element *b, const size_t n, Element *out,
+               Element *scratch) {
+  if (n < karatsuba_threshold) {
+    schoolbook(a, n, b, n, out);
+    return;
+  }
+
+  const size_t m = n / 2;
+  const size_t h = n - m;
+  Element *sum_a = scratch;
+  Element *sum_b = sum_a + h;
+  Element *middle = sum_b + h;
+  Element *next = middle + 2 * h - 1;
+
+  karatsuba(a, b, m, out, next);
+  out[2 * m - 1] = Element(0);
+  karatsuba(a + m, b + m, h, out + 2 * m, next);
+
+  std::copy(a + m, a + n, sum_a);
+  std::copy(b + m, b + n, sum_b);
+  for (size_t i = 0; i < m; i++) {
+    sum_a[i] = sum_a[i] + a[i];
+    sum_b[i] = sum_b[i] + b[i];
+  }
+  karatsuba(sum_a, sum_b, h, middle, next);
+
+  for (size_t i = 0; i < 2 * m - 1; i++)
+    middle[i] = middle[i] - out[i];
+  for (size_t i = 0; i < 2 * h - 1; i++)
+    middle[i] = middle[i] - out[2 * m + i];
+  for (size_t i = 0; i < 2 * h - 1; i++)
+    out[m + i] = out[m + i] + middle[i];
+}
+}
+
+/* Number of elements of scratch space multiply() needs. */
+inline size_t multiply_scratch(const size_t na, const size_t nb) {
+  const size_t n = std::min(na, nb);
+  if (n < detail::karatsuba_threshold)
+    return 0;
+  return 3 * n - 1 + detail::karatsuba_scratch(n);
+}
+
+/* out[0, na + nb - 1) = a * b. Unbalanced operands are multiplied in chunks of
+ * the length of the shorter one. out must not overlap the operands. */
+template <typename Element>
+void multiply(const Element *a, size_t na, const Element *b, size_t nb,
+              Element *out, Element *scratch) {
+  if (na < nb) {
+    std::swap(a, b);
+    std::swap(na, nb);
+  }
+  if (nb < detail::karatsuba_threshold) {
+    detail::schoolbook(a, na, b, nb, out);
+    return;
+  }
+
+  Element *product = scratch;
+  Element *padded = product + 2 * nb - 1;
+  Element *next = padded + nb;
+  const size_t size = na + nb - 1;
+
+  std::fill(out, out + size, Element(0));
+  for (size_t i = 0; i < na; i += nb) {
+    const Element *chunk = a + i;
+    if (na - i < nb) {
+      std::fill(std::copy(a + i, a + na, padded), padded + nb, Element(0));
+      chunk = padded;
+    }
+    detail::karatsuba(chunk, b, nb, product, next);
+    const size_t count = std::min(2 * nb - 1, size - i);
+    for (size_t j = 0; j < count; j++)
+      out[i + j] = out[i + j] + product[j];
+  }
+}
+
+/* Evaluate the polynomial with the coefficients [first, last) (lowest degree
+ * first) at every point in [points_first, points_last).
+ *
+ * The coefficients are split into 'lanes' interleaved polynomials:
+ *
+ *           lanes - 1
+ *             __
+ *     p(x) =  \   x^l * P_l(x^lanes),  P_l(y) = Σ_k c_{k * lanes + l} y^k
+ *             /_
+ *            l = 0
+ *
+ * All P_l are evaluated at once by Horner's method, which multiplies a whole
+ * block of coefficients by the constant x^lanes in every step. Up to 'batch'
+ * points share one pass over the coefficients, so that every block is loaded
+ * once and then multiplied for each point from the L1 cache. Short
+ * polynomials are evaluated at the points of a batch interleaved, which hides
+ * the latency of the multiplications.
+ */
+template <typename Element>
+void horner(const Element *first, const Element *last,
+            const Element *points_first, const Element *points_last,
+            Element *out) {
+  constexpr size_t lanes = 32;
+  constexpr size_t batch = 16;
+  const size_t size = static_cast<size_t>(last - first);
+
+  while (points_first != points_last) {
+    const size_t points = std::min(
+        batch, static_cast<size_t>(points_last - points_first));
+    const Element *x = points_first;
+
+    if (size < 2 * lanes) {
+      Element results[batch];
+      std::fill(results, results + points, Element(0));
+      for (auto it = last; it != first;) {
+        const Element &c = *--it;
+        for (size_t p = 0; p < points; p++)
+          results[p] = results[p] * x[p] + c;
+      }
+      out = std::copy(results, results + points, out);
+      points_first += points;
+      continue;
+    }
+
+    static_vector<multiplier<Element>, batch> steps;
+    for (size_t p = 0; p < points; p++) {
+      Element x_lanes(1);
+      for (size_t i = 0; i < lanes; i++)
+        x_lanes = x_lanes * x[p];
+      steps.emplace_back(x_lanes);
+    }
+
+    /* highest, possibly incomplete, block first */
+    const size_t blocks = (size + lanes - 1) / lanes;
+    Element acc[batch][lanes];
+    for (size_t p = 0; p < points; p++) {
+      std::fill(acc[p], acc[p] + lanes, Element(0));
+      std::copy(first + (blocks - 1) * lanes, last, acc[p]);
+    }
+
+    for (size_t block = blocks - 1; block--;) {
+      const Element *coefficients = first + block * lanes;
+      for (size_t p = 0; p < points; p++) {
+        steps[p].scale(acc[p], acc[p] + lanes);
+        for (size_t l = 0; l < lanes; l++)
+          acc[p][l] = acc[p][l] + coefficients[l];
+      }
+    }
+
+    for (size_t p = 0; p < points; p++) {
+      Element result(0);
+      for (size_t l = lanes; l--;)
+        result = result * x[p] + acc[p][l];
+      *out++ = result;
+    }
+    points_first += points;
+  }
+}
+}
+}
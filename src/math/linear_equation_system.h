@@ -1,57 +1,39 @@
 #pragma once
 
-namespace math {
-
-template <typename Polytype>
-class linear_equation_system {
-  using row_type = std::vector<Polytype>;
-  using iterator = typename row_type::iterator;
-  using const_iterator = typename row_type::const_iterator;
-  std::vector<Polytype> rows;
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
 
-  linear_equation_system reduced_echelon_form() const {
-    std::vector<Polytype> nrows(this->rows);
+#include "math/gaussian_elimination.h"
+#include "math/static_vector.h"
 
-    /* make sure rows are sorted with the left-most elements at the top */
-    std::sort(std::begin(nrows), std::end(nrows),
-              [](const Polytype &lhs,
-                 const Polytype &rhs) { return lhs.degree() > rhs.degree(); });
-
-    /* empty rows */
-    if (nrows.front().degree() < 0)
-      return linear_equation_system(nrows);
+namespace math {
 
-    for (auto first_row = nrows.begin(); first_row != nrows.end();
-         ++first_row) {
-      size_t offset = static_cast<size_t>(first_row->degree());
-      (*first_row) *= first_row->at(offset).inverse();
-      for (auto next_rows = first_row + 1; next_rows != nrows.end();
-           ++next_rows) {
-        /* only add if not already zero */
-        if (next_rows->at(offset)) {
-          size_t next_offset = static_cast<size_t>(next_rows->degree());
-          (*next_rows) += (*first_row) * next_rows->at(next_offset);
-        }
-      }
-      // std::cout << matrix(nrows) << std::endl;
-    }
+namespace detail {
+/* The elements of a system of as many rows as unknowns */
+template <typename Rows> struct dense_storage {
+  using type = std::vector<typename Rows::value_type::coefficient_type>;
+};
 
-    for (auto modify = nrows.rbegin() + 1; modify != nrows.rend(); ++modify) {
-      for (auto row = nrows.crbegin(); row != modify; ++row) {
-        const size_t index =
-            static_cast<size_t>(std::distance(std::crbegin(nrows), row) + 1);
-        auto factor = modify->at(index);
-        (*modify) += (*row) * factor;
-      }
-    }
+template <typename Polytype, size_t Capacity>
+struct dense_storage<static_vector<Polytype, Capacity> > {
+  using type = static_vector<typename Polytype::coefficient_type,
+                             Capacity * (Capacity + 1)>;
+};
+}
 
-    return linear_equation_system(std::move(nrows));
-  }
+/* Rows may be a math::static_vector to avoid dynamic memory allocation. */
+template <typename Polytype, typename Rows = std::vector<Polytype> >
+class linear_equation_system {
+  using row_type = Rows;
+  using iterator = typename row_type::iterator;
+  using const_iterator = typename row_type::const_iterator;
+  row_type rows;
 
 public:
   linear_equation_system() = default;
-  linear_equation_system(const std::vector<Polytype> &v) : rows(v) {}
-  linear_equation_system(std::vector<Polytype> &&v) : rows(std::move(v)) {}
+  linear_equation_system(const row_type &v) : rows(v) {}
+  linear_equation_system(row_type &&v) : rows(std::move(v)) {}
   linear_equation_system(linear_equation_system &&) = default;
 
   void push_back(const Polytype &row) { rows.push_back(row); }
@@ -64,25 +46,37 @@ public:
   iterator end() noexcept { return rows.end(); }
   const_iterator end() const noexcept { return rows.end(); }
 
+  /* Row i is the polynomial b_i + a_i1 x + ... + a_in x^n of the equation
+   * a_i1 s_(n-1) + ... + a_in s_0 = b_i. Returns s_0, ..., s_(n-1). */
   Polytype solution() const {
-    linear_equation_system copy(reduced_echelon_form());
+    using Element = typename Polytype::coefficient_type;
+    ssize_t degree = 0;
+    for (const auto &row : rows)
+      degree = std::max(degree, row.degree());
+    const auto unknowns = static_cast<size_t>(degree);
+
+    dense_system<Element, typename detail::dense_storage<Rows>::type> system(
+        rows.size(), unknowns + 1);
+    for (size_t i = 0; i < rows.size(); i++) {
+      const auto &row = rows[i];
+      const auto size = std::min(row.size(), unknowns + 1);
+      for (size_t j = 1; j < size; j++)
+        system[i][unknowns - j] = row[j];
+      if (size)
+        system[i][unknowns] = row[0];
+    }
 
-    /*
-     * Matrix:
-     * x = 0 0 1
-     * y = 0 1 0
-     * z = 1 0 0
-     *     ^ back()[1].
-     * Must be non-zero, otherwise the system is overdetermined.
-     * Since it is in row-echelon form, it must be one.
-     */
-    if (copy.back()[1] != typename Polytype::coefficient_type(1))
+    /* a column without pivot or a row 0 = b_i with b_i != 0 */
+    const size_t rank = system.eliminate(unknowns);
+    bool consistent = rank == unknowns;
+    for (size_t i = rank; consistent && i < rows.size(); i++)
+      consistent = !system[i][unknowns];
+    if (!consistent)
       throw std::runtime_error("Linear equation system not solvable");
 
     Polytype s;
-    for (const auto &row : copy) {
-      s.push_back(row[0]);
-    }
+    for (size_t i = 0; i < unknowns; i++)
+      s.push_back(system[i][unknowns]);
 
     return s;
   }
@@ -3,20 +3,224 @@
 #include <vector>
 #include <type_traits>
 #include <iomanip>
+#include <iterator>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+namespace detail {
+/* Rows of a matrix start on their own cache line */
+static constexpr size_t matrix_alignment = 64;
+
+template <typename T, size_t Alignment> struct aligned_allocator {
+  using value_type = T;
+  template <typename U> struct rebind {
+    using other = aligned_allocator<U, Alignment>;
+  };
+
+  aligned_allocator() = default;
+  template <typename U>
+  aligned_allocator(const aligned_allocator<U, Alignment> &) noexcept {}
+
+  T *allocate(const size_t n) {
+    void *p = nullptr;
+    if (posix_memalign(&p, Alignment, n * sizeof(T)))
+      throw std::bad_alloc();
+    return static_cast<T *>(p);
+  }
+  void deallocate(T *p, size_t) noexcept { std::free(p); }
+
+  template <typename U>
+  bool operator==(const aligned_allocator<U, Alignment> &) const noexcept {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const aligned_allocator<U, Alignment> &) const noexcept {
+    return false;
+  }
+};
+
+/* Iterator over every stride-th element, e.g. down a column */
+template <typename T> class strided_iterator {
+  T *p;
+  ptrdiff_t stride;
+
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename std::remove_const<T>::type;
+  using difference_type = ptrdiff_t;
+  using pointer = T *;
+  using reference = T &;
+
+  strided_iterator(T *p_, const ptrdiff_t stride_) : p(p_), stride(stride_) {}
+
+  reference operator*() const { return *p; }
+  pointer operator->() const { return p; }
+  reference operator[](const difference_type n) const { return p[n * stride]; }
+
+  strided_iterator &operator++() {
+    p += stride;
+    return *this;
+  }
+  strided_iterator operator++(int) {
+    auto copy(*this);
+    p += stride;
+    return copy;
+  }
+  strided_iterator &operator--() {
+    p -= stride;
+    return *this;
+  }
+  strided_iterator operator--(int) {
+    auto copy(*this);
+    p -= stride;
+    return copy;
+  }
+  strided_iterator &operator+=(const difference_type n) {
+    p += n * stride;
+    return *this;
+  }
+  strided_iterator &operator-=(const difference_type n) {
+    p -= n * stride;
+    return *this;
+  }
+  strided_iterator operator+(const difference_type n) const {
+    return strided_iterator(p + n * stride, stride);
+  }
+  strided_iterator operator-(const difference_type n) const {
+    return strided_iterator(p - n * stride, stride);
+  }
+  difference_type operator-(const strided_iterator &rhs) const {
+    return (p - rhs.p) / stride;
+  }
+
+  bool operator==(const strided_iterator &rhs) const { return p == rhs.p; }
+  bool operator!=(const strided_iterator &rhs) const { return p != rhs.p; }
+  bool operator<(const strided_iterator &rhs) const {
+    return stride > 0 ? p < rhs.p : p > rhs.p;
+  }
+};
+}
+
+/* A row or column of a matrix, without ownership. Rows are contiguous. */
+template <typename T> class vector_view {
+  T *first;
+  size_t size_;
+  ptrdiff_t stride_;
+
+public:
+  using value_type = typename std::remove_const<T>::type;
+  using size_type = size_t;
+  using iterator = detail::strided_iterator<T>;
+  using const_iterator = detail::strided_iterator<const T>;
+
+  vector_view(T *first_, const size_t size, const ptrdiff_t stride = 1)
+      : first(first_), size_(size), stride_(stride) {}
+  /* a view of a mutable vector is a view of a constant one as well */
+  template <typename U,
+            typename = std::enable_if_t<std::is_same<const U, T>::value> >
+  vector_view(const vector_view<U> &other)
+      : first(other.data()), size_(other.size()), stride_(other.stride()) {}
+
+  size_t size() const noexcept { return size_; }
+  ptrdiff_t stride() const noexcept { return stride_; }
+  /* contiguous for rows only */
+  T *data() const noexcept { return first; }
+
+  T &operator[](const size_t i) const noexcept {
+    return first[static_cast<ptrdiff_t>(i) * stride_];
+  }
+  T &at(const size_t i) const {
+    if (i >= size_)
+      throw std::out_of_range("vector_view index out of range");
+    return (*this)[i];
+  }
+
+  iterator begin() const noexcept { return iterator(first, stride_); }
+  iterator end() const noexcept {
+    return iterator(first + static_cast<ptrdiff_t>(size_) * stride_, stride_);
+  }
+  const_iterator cbegin() const noexcept {
+    return const_iterator(first, stride_);
+  }
+  const_iterator cend() const noexcept {
+    return const_iterator(first + static_cast<ptrdiff_t>(size_) * stride_,
+                          stride_);
+  }
+};
+
+/* A rows x columns block of a matrix, without ownership. Element (i, j) is at
+ * first[i * row_stride + j * column_stride], so a transposed view only swaps
+ * the strides. */
+template <typename T> class matrix_view {
+  T *first;
+  size_t rows_;
+  size_t cols;
+  ptrdiff_t row_stride;
+  ptrdiff_t column_stride;
+
+public:
+  matrix_view(T *first_, const size_t rows, const size_t columns,
+              const ptrdiff_t row_stride_, const ptrdiff_t column_stride_ = 1)
+      : first(first_), rows_(rows), cols(columns), row_stride(row_stride_),
+        column_stride(column_stride_) {}
+
+  size_t rows() const noexcept { return rows_; }
+  size_t columns() const noexcept { return cols; }
+
+  T &operator()(const size_t row, const size_t col) const noexcept {
+    return first[static_cast<ptrdiff_t>(row) * row_stride +
+                 static_cast<ptrdiff_t>(col) * column_stride];
+  }
+
+  vector_view<T> operator[](const size_t row) const noexcept {
+    return vector_view<T>(&(*this)(row, 0), cols, column_stride);
+  }
+  vector_view<T> at(const size_t row) const {
+    if (row >= rows_)
+      throw std::out_of_range("matrix_view row out of range");
+    return (*this)[row];
+  }
+  vector_view<T> column(const size_t col) const noexcept {
+    return vector_view<T>(&(*this)(0, col), rows_, row_stride);
+  }
+
+  matrix_view transposed() const noexcept {
+    return matrix_view(first, cols, rows_, column_stride, row_stride);
+  }
+  matrix_view block(const size_t row, const size_t col, const size_t rows,
+                    const size_t columns) const noexcept {
+    return matrix_view(&(*this)(row, col), rows, columns, row_stride,
+                       column_stride);
+  }
+};
 
 template <typename T> class matrix;
 template <typename T>
 std::ostream &operator<<(std::ostream &, const matrix<T> &);
 
+/* A dense matrix in one buffer. Rows are stored one after another, each padded
+ * to a multiple of the cache line size, so that every row starts on a cache
+ * line of its own. */
 template <typename T> class matrix {
-  using row_type = std::vector<T>;
-  using rep_type = std::vector<row_type>;
-
-  using iterator = typename rep_type::iterator;
-  using const_iterator = typename rep_type::const_iterator;
+  using rep_type =
+      std::vector<T, detail::aligned_allocator<T, detail::matrix_alignment> >;
 
   rep_type data;
-  size_t cols;
+  size_t rows_ = 0;
+  size_t cols = 0;
+  size_t stride = 0;
+
+  static size_t stride_for(const size_t columns) {
+    constexpr size_t per_line =
+        std::max<size_t>(detail::matrix_alignment / sizeof(T), 1);
+    return (columns + per_line - 1) / per_line * per_line;
+  }
 
   template <typename A> void check_dimension(const std::vector<A> &rhs) const {
     if (rhs.size() != cols) {
@@ -28,41 +232,149 @@ template <typename T> class matrix {
     }
   }
 
+  template <typename U> class row_iterator {
+    U *p;
+    size_t cols;
+    size_t stride;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = vector_view<U>;
+    using difference_type = ptrdiff_t;
+    using pointer = void;
+    using reference = vector_view<U>;
+
+    row_iterator(U *p_, const size_t cols_, const size_t stride_)
+        : p(p_), cols(cols_), stride(stride_) {}
+
+    reference operator*() const { return vector_view<U>(p, cols); }
+    row_iterator &operator++() {
+      p += stride;
+      return *this;
+    }
+    row_iterator operator++(int) {
+      auto copy(*this);
+      p += stride;
+      return copy;
+    }
+    bool operator==(const row_iterator &rhs) const { return p == rhs.p; }
+    bool operator!=(const row_iterator &rhs) const { return p != rhs.p; }
+  };
+
 public:
-  using value_type = row_type;
-  using size_type = typename row_type::size_type;
+  using value_type = vector_view<T>;
+  using size_type = size_t;
+  using iterator = row_iterator<T>;
+  using const_iterator = row_iterator<const T>;
 
   matrix() = default;
-  matrix(const std::vector<T> &v) : data(1, v), cols(v.size()) {}
+  matrix(const std::vector<T> &v)
+      : data(stride_for(v.size()), T()), rows_(1), cols(v.size()),
+        stride(stride_for(v.size())) {
+    std::copy(std::cbegin(v), std::cend(v), std::begin(data));
+  }
   matrix(const size_t rows, const size_t cols_)
-      : data(rows, std::vector<T>(cols_, T())), cols(cols_) {}
+      : data(rows * stride_for(cols_), T()), rows_(rows), cols(cols_),
+        stride(stride_for(cols_)) {}
   matrix(const matrix &) = default;
   matrix(matrix &&) = default;
+  matrix &operator=(const matrix &) = default;
+  matrix &operator=(matrix &&) = default;
 
-  void push_back(const row_type &e) { data.push_back(e); }
-  void push_back(row_type &&e) { data.push_back(std::move(e)); }
-  row_type &at(size_type i) { return data.at(i); }
-  const row_type &at(size_type i) const { return data.at(i); }
+  template <typename Row> void push_back(const Row &row) {
+    if (!rows_ && !cols) {
+      cols = row.size();
+      stride = stride_for(cols);
+    }
+    if (row.size() != cols)
+      throw std::runtime_error("Row dimension does not match the matrix.");
+    data.resize((rows_ + 1) * stride, T());
+    std::copy(std::cbegin(row), std::cend(row),
+              std::begin(data) + static_cast<ptrdiff_t>(rows_ * stride));
+    rows_++;
+  }
+
+  vector_view<T> operator[](const size_type i) noexcept {
+    return vector_view<T>(data.data() + i * stride, cols);
+  }
+  vector_view<const T> operator[](const size_type i) const noexcept {
+    return vector_view<const T>(data.data() + i * stride, cols);
+  }
+  vector_view<T> at(const size_type i) {
+    if (i >= rows_)
+      throw std::out_of_range("matrix row out of range");
+    return (*this)[i];
+  }
+  vector_view<const T> at(const size_type i) const {
+    if (i >= rows_)
+      throw std::out_of_range("matrix row out of range");
+    return (*this)[i];
+  }
 
-  iterator begin() noexcept { return data.begin(); }
-  iterator end() noexcept { return data.end(); }
-  const_iterator begin() const noexcept { return data.begin(); }
-  const_iterator end() const noexcept { return data.begin(); }
-  const_iterator cbegin() const noexcept { return data.cbegin(); }
-  const_iterator cend() const noexcept { return data.cend(); }
+  T &operator()(const size_t row, const size_t col) noexcept {
+    return data[row * stride + col];
+  }
+  const T &operator()(const size_t row, const size_t col) const noexcept {
+    return data[row * stride + col];
+  }
+
+  vector_view<T> column(const size_t col) noexcept {
+    return vector_view<T>(data.data() + col, rows_,
+                          static_cast<ptrdiff_t>(stride));
+  }
+  vector_view<const T> column(const size_t col) const noexcept {
+    return vector_view<const T>(data.data() + col, rows_,
+                                static_cast<ptrdiff_t>(stride));
+  }
+
+  matrix_view<T> view() noexcept {
+    return matrix_view<T>(data.data(), rows_, cols,
+                          static_cast<ptrdiff_t>(stride));
+  }
+  matrix_view<const T> view() const noexcept {
+    return matrix_view<const T>(data.data(), rows_, cols,
+                                static_cast<ptrdiff_t>(stride));
+  }
+  matrix_view<const T> transposed() const noexcept {
+    return view().transposed();
+  }
+  matrix_view<const T> block(const size_t row, const size_t col,
+                             const size_t rows, const size_t columns) const
+      noexcept {
+    return view().block(row, col, rows, columns);
+  }
+
+  iterator begin() noexcept { return iterator(data.data(), cols, stride); }
+  iterator end() noexcept {
+    return iterator(data.data() + rows_ * stride, cols, stride);
+  }
+  const_iterator begin() const noexcept { return cbegin(); }
+  const_iterator end() const noexcept { return cend(); }
+  const_iterator cbegin() const noexcept {
+    return const_iterator(data.data(), cols, stride);
+  }
+  const_iterator cend() const noexcept {
+    return const_iterator(data.data() + rows_ * stride, cols, stride);
+  }
 
   size_t columns() const { return cols; }
-  size_t rows() const { return data.size(); }
+  size_t rows() const { return rows_; }
 
-  template <typename A, typename R = typename std::common_type<T, A>::type>
-  std::vector<R> operator*(const std::vector<A> &rhs) const {
+  /* out[row] = Σ_col (*this)(row, col) * rhs[col] */
+  template <typename A, typename OutputIt>
+  void multiply(const std::vector<A> &rhs, OutputIt out) const {
+    using R = typename std::common_type<T, A>::type;
     check_dimension(rhs);
+    for (size_t row = 0; row < rows_; row++, ++out) {
+      const T *first = data.data() + row * stride;
+      *out = std::inner_product(first, first + cols, std::cbegin(rhs), R(0));
+    }
+  }
 
-    std::vector<R> result;
-    for (const auto &row : *this)
-      result.push_back(std::inner_product(std::cbegin(row), std::cend(row),
-                                          std::cbegin(rhs), R(0)));
-
+  template <typename A, typename R = typename std::common_type<T, A>::type>
+  std::vector<R> operator*(const std::vector<A> &rhs) const {
+    std::vector<R> result(rows_);
+    multiply(rhs, std::begin(result));
     return result;
   }
 
@@ -79,3 +391,77 @@ std::ostream &operator<<(std::ostream &os, const matrix<T> &matrix) {
   return os << std::endl;
 }
 
+/* A matrix over GF(2) with 64 columns per word. Row i, column j is bit j % 64
+ * of word j / 64 of the row; bits past the last column are zero. */
+class gf2_matrix {
+  using allocator =
+      detail::aligned_allocator<uint64_t, detail::matrix_alignment>;
+  using rep_type = std::vector<uint64_t, allocator>;
+
+  rep_type data;
+  size_t rows_ = 0;
+  size_t cols = 0;
+  size_t stride = 0;
+
+public:
+  static constexpr size_t word_bits = 64;
+
+  static constexpr size_t words_for(const size_t columns) noexcept {
+    return (columns + word_bits - 1) / word_bits;
+  }
+
+  gf2_matrix() = default;
+  gf2_matrix(const size_t rows, const size_t columns)
+      : data(rows * words_for(columns), 0), rows_(rows), cols(columns),
+        stride(words_for(columns)) {}
+  /* every non-zero element of H is a one */
+  template <typename T>
+  explicit gf2_matrix(const matrix<T> &H) : gf2_matrix(H.rows(), H.columns()) {
+    for (size_t row = 0; row < rows_; row++) {
+      const T *first = H[row].data();
+      uint64_t *words = (*this)[row];
+      for (size_t col = 0; col < cols; col++)
+        words[col / word_bits] |= uint64_t(bool(first[col]))
+                                  << (col % word_bits);
+    }
+  }
+
+  size_t rows() const noexcept { return rows_; }
+  size_t columns() const noexcept { return cols; }
+  /* words per row */
+  size_t words() const noexcept { return stride; }
+
+  uint64_t *operator[](const size_t row) noexcept {
+    return data.data() + row * stride;
+  }
+  const uint64_t *operator[](const size_t row) const noexcept {
+    return data.data() + row * stride;
+  }
+
+  bool get(const size_t row, const size_t col) const noexcept {
+    return ((*this)[row][col / word_bits] >> (col % word_bits)) & 1;
+  }
+  void set(const size_t row, const size_t col, const bool value) noexcept {
+    uint64_t &word = (*this)[row][col / word_bits];
+    const uint64_t mask = uint64_t(1) << (col % word_bits);
+    word = (word & ~mask) | ((0 - uint64_t(value)) & mask);
+  }
+
+  /* <row, b> over GF(2) for b packed like a row */
+  bool parity(const size_t row, const uint64_t *b) const noexcept {
+    const uint64_t *words = (*this)[row];
+    uint64_t sum = 0;
+    for (size_t word = 0; word < stride; word++)
+      sum ^= words[word] & b[word];
+    return __builtin_parityll(sum);
+  }
+
+  /* H b = 0, stopping at the first unsatisfied check */
+  bool in_kernel(const uint64_t *b) const noexcept {
+    for (size_t row = 0; row < rows_; row++) {
+      if (parity(row, b))
+        return false;
+    }
+    return true;
+  }
+};
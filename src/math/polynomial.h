@@ -5,37 +5,25 @@
 #include <utility>
 #include <functional>
 #include <initializer_list>
+#include <iterator>
 
-namespace math {
-
-namespace gf {
-
-struct brute_force_tag {};
-struct chien_tag {};
+#include "math/kernels.h"
+#include "math/roots.h"
+#include "math/static_vector.h"
 
-template <typename Field, typename Coefficient = typename Field::element_type,
-          typename Polynomial>
-std::vector<Coefficient> roots(const Polynomial &p, brute_force_tag) {
-  /* I need a type for the variable x, it has not necessarily something to do
-   * with the coefficient type */
-  std::vector<Coefficient> zeroes;
-
-  for (const auto &element : Field{}) {
-    if (element && !p(element))
-      zeroes.push_back(element);
-  }
-  return zeroes;
-}
-}
+namespace math {
 
-template <typename Coefficient> class polynomial {
-  using rep_type = std::vector<Coefficient>;
+/* Container holds the coefficients, lowest degree first. It defaults to a
+ * std::vector; math::static_polynomial uses storage of fixed capacity. */
+template <typename Coefficient, typename Container = std::vector<Coefficient> >
+class polynomial {
+  using rep_type = Container;
   using iterator = typename rep_type::iterator;
   using const_iterator = typename rep_type::const_iterator;
   using reverse_iterator = typename rep_type::reverse_iterator;
   using const_reverse_iterator = typename rep_type::const_reverse_iterator;
 
-  rep_type data;
+  rep_type rep;
 
   /* return quotient and remainder */
   std::pair<polynomial, polynomial> division(const polynomial &lhs,
@@ -46,27 +34,24 @@ template <typename Coefficient> class polynomial {
     if (lhs.degree() < rhs.degree())
       return std::make_tuple(polynomial(1, Coefficient(0)), lhs);
 
+    const size_t divisor_degree = static_cast<size_t>(rhs.degree());
     const size_t quotient_degree =
-        static_cast<size_t>(lhs.degree() - rhs.degree());
+        static_cast<size_t>(lhs.degree()) - divisor_degree;
     polynomial q(quotient_degree + 1, Coefficient(0));
     polynomial r(lhs);
 
-    auto r_lead = r.rlead();
-    auto rhs_lead = rhs.crlead();
-    auto q_it = std::rbegin(q);
-
-    for (; r.degree() >= rhs.degree(); ++r_lead, ++q_it) {
-      auto coefficient = *r_lead / *rhs_lead;
+    const Coefficient lead_inverse = Coefficient(1) / rhs.rep.at(divisor_degree);
+    const Coefficient *divisor = rhs.rep.data();
+    Coefficient *remainder = r.rep.data();
 
-      // q = q + t;
-      (*q_it) += coefficient;
+    for (size_t i = quotient_degree + 1; i--;) {
+      const auto coefficient = remainder[i + divisor_degree] * lead_inverse;
+      q.rep[i] += coefficient;
 
       // r = r - (rhs * t);
-      // leading zero coeffs in rhs possible, so use lead instead of crbegin()
-      std::transform(r_lead, r_lead + rhs.degree() + 1, rhs_lead, r_lead,
-                     [=](const Coefficient &lhs_, const Coefficient &rhs_) {
-        return lhs_ - (rhs_ * coefficient);
-      });
+      // leading zero coeffs in rhs possible, so use the degree instead of size
+      kernel::axpy(remainder + i, remainder + i + divisor_degree + 1, divisor,
+                   Coefficient(0) - coefficient);
     }
 
     /* TODO remove leading zeroes */
@@ -76,14 +61,15 @@ template <typename Coefficient> class polynomial {
 
   template <typename Op>
   polynomial &element_wise(const polynomial &rhs, Op &&op) {
-    if (data.size() < rhs.data.size()) {
-      data.reserve(rhs.data.size());
-      std::fill_n(std::back_inserter(data), rhs.data.size() - data.size(),
+    if (rep.size() < rhs.rep.size()) {
+      rep.reserve(rhs.rep.size());
+      std::fill_n(std::back_inserter(rep), rhs.rep.size() - rep.size(),
                   Coefficient(0));
     }
 
-    std::transform(std::cbegin(rhs.data), std::cend(rhs.data),
-                   std::cbegin(data), std::begin(data),
+    /* op(lhs, rhs), which matters for non-commutative op, i.e. minus */
+    std::transform(std::cbegin(rep), std::cbegin(rep) + rhs.rep.size(),
+                   std::cbegin(rhs.rep), std::begin(rep),
                    std::forward<Op &&>(op));
 
     /* todo remove leading zeroes */
@@ -91,17 +77,16 @@ template <typename Coefficient> class polynomial {
     return *this;
   }
 
-  typename std::vector<Coefficient>::const_reverse_iterator crlead() const
-      noexcept {
-    return std::find_if(std::crbegin(data), std::crend(data),
+  const_reverse_iterator crlead() const noexcept {
+    return std::find_if(std::crbegin(rep), std::crend(rep),
                         [](const Coefficient &e) { return e; });
   }
 
-  typename std::vector<Coefficient>::reverse_iterator rlead() {
-    auto lead = std::find_if(std::rbegin(data), std::rend(data),
+  reverse_iterator rlead() {
+    auto lead = std::find_if(std::rbegin(rep), std::rend(rep),
                              [](const Coefficient &e) { return e; });
-    if (lead == std::rend(data))
-      return std::rend(data) - 1;
+    if (lead == std::rend(rep))
+      return std::rend(rep) - 1;
 
     return lead;
   }
@@ -112,10 +97,10 @@ public:
   using value_type = Coefficient;
 
   polynomial() = default;
-  polynomial(const Coefficient &e) : data(1, e) {}
+  polynomial(const Coefficient &e) : rep(1, e) {}
   polynomial(const polynomial &) = default;
-  polynomial(std::initializer_list<Coefficient> il) : data(std::move(il)) {}
-  polynomial(size_type size, Coefficient c) : data(size, c) {}
+  polynomial(std::initializer_list<Coefficient> il) : rep(std::move(il)) {}
+  polynomial(size_type size, Coefficient c) : rep(size, c) {}
   polynomial(polynomial &&) = default;
   polynomial &operator=(const polynomial &rhs) = default;
   polynomial &operator=(polynomial &&) = default;
@@ -123,74 +108,83 @@ public:
   explicit polynomial(
       std::vector<typename Coefficient::storage_type> coefficients) {
     for (const auto &element : coefficients) {
-      data.push_back(Coefficient(element));
+      rep.push_back(Coefficient(element));
     }
   }
-  explicit polynomial(const std::vector<Coefficient> &v) : data(v) {}
+  explicit polynomial(const std::vector<Coefficient> &v)
+      : rep(std::cbegin(v), std::cend(v)) {}
+  template <typename InputIt,
+            typename = typename std::iterator_traits<InputIt>::value_type>
+  polynomial(InputIt first, InputIt last) : rep(first, last) {}
 
   ssize_t degree() const noexcept {
-    auto it = std::find_if(std::crbegin(data), std::crend(data),
+    auto it = std::find_if(std::crbegin(rep), std::crend(rep),
                            [](const Coefficient &e) { return e; });
-    return std::distance(it, std::crend(data)) - 1;
+    return std::distance(it, std::crend(rep)) - 1;
   }
 
-  typename std::vector<Coefficient>::size_type weight() const noexcept {
-    return std::count_if(std::cbegin(data), std::cend(data),
+  size_type weight() const noexcept {
+    return std::count_if(std::cbegin(rep), std::cend(rep),
                          [](const auto &e) { return e; });
   }
 
-  size_type size() const { return data.size(); }
+  size_type size() const { return rep.size(); }
 
-  iterator begin() noexcept { return data.begin(); }
-  iterator end() noexcept { return data.end(); }
-  const_iterator begin() const noexcept { return data.begin(); }
-  const_iterator end() const noexcept { return data.end(); }
-  const_iterator cbegin() const noexcept { return data.cbegin(); }
-  const_iterator cend() const noexcept { return data.cend(); }
-  reverse_iterator rbegin() noexcept { return data.rbegin(); }
-  reverse_iterator rend() noexcept { return data.rend(); }
-  const_reverse_iterator rbegin() const noexcept { return data.rbegin(); }
-  const_reverse_iterator rend() const noexcept { return data.rend(); }
-  const_reverse_iterator crbegin() const noexcept { return data.crbegin(); }
-  const_reverse_iterator crend() const noexcept { return data.crend(); }
+  iterator begin() noexcept { return rep.begin(); }
+  iterator end() noexcept { return rep.end(); }
+  const_iterator begin() const noexcept { return rep.begin(); }
+  const_iterator end() const noexcept { return rep.end(); }
+  const_iterator cbegin() const noexcept { return rep.cbegin(); }
+  const_iterator cend() const noexcept { return rep.cend(); }
+  reverse_iterator rbegin() noexcept { return rep.rbegin(); }
+  reverse_iterator rend() noexcept { return rep.rend(); }
+  const_reverse_iterator rbegin() const noexcept { return rep.rbegin(); }
+  const_reverse_iterator rend() const noexcept { return rep.rend(); }
+  const_reverse_iterator crbegin() const noexcept { return rep.crbegin(); }
+  const_reverse_iterator crend() const noexcept { return rep.crend(); }
 
-  void reserve(size_type new_capacity) { data.reserve(new_capacity); }
+  void reserve(size_type new_capacity) { rep.reserve(new_capacity); }
+  /* keeps the capacity */
+  void clear() noexcept { rep.clear(); }
 
-  void push_back(const value_type &v) { data.push_back(v); }
-  void push_back(value_type &&v) { data.push_back(std::move(v)); }
+  void push_back(const value_type &v) { rep.push_back(v); }
+  void push_back(value_type &&v) { rep.push_back(std::move(v)); }
 
-  value_type &at(size_type i) { return data.at(i); }
-  const value_type &at(size_type i) const { return data.at(i); }
+  Coefficient *data() noexcept { return rep.data(); }
+  const Coefficient *data() const noexcept { return rep.data(); }
 
-  rep_type to_vector() const {
-    return data;
+  value_type &at(size_type i) { return rep.at(i); }
+  const value_type &at(size_type i) const { return rep.at(i); }
+
+  std::vector<Coefficient> to_vector() const {
+    return std::vector<Coefficient>(std::cbegin(rep), std::cend(rep));
   }
 
   Coefficient highest() const {
-    if (data.empty())
+    if (rep.empty())
       throw std::out_of_range("Polynomial has no terms.");
 
-    return data.at(degree());
+    return rep.at(degree());
   }
 
   polynomial &reverse() {
-    std::reverse(std::begin(data), std::begin(data) + degree() + 1);
+    std::reverse(std::begin(rep), std::begin(rep) + degree() + 1);
     return *this;
   }
 
   polynomial simplified() const {
     polynomial copy;
-    copy.data.reserve(data.size());
-    std::copy(std::cbegin(data), std::cbegin(data) + this->degree() + 1,
-              std::back_inserter(copy.data));
+    copy.rep.reserve(rep.size());
+    std::copy(std::cbegin(rep), std::cbegin(rep) + this->degree() + 1,
+              std::back_inserter(copy.rep));
 
     return copy;
   }
 
   const Coefficient &operator[](const size_t &index) const {
-    return data.at(index);
+    return rep.at(index);
   }
-  Coefficient &operator[](const size_t &index) { return data.at(index); }
+  Coefficient &operator[](const size_t &index) { return rep.at(index); }
 
   polynomial operator+(const polynomial &rhs) const {
     auto copy(*this);
@@ -200,7 +194,7 @@ public:
 
   polynomial operator-(const polynomial &rhs) const {
     auto copy(*this);
-    copy += rhs;
+    copy -= rhs;
     return copy;
   }
 
@@ -208,25 +202,17 @@ public:
     if (!(*this && rhs))
       return polynomial({ Coefficient(0) });
 
-    auto rhs_ = rhs.simplified();
-    const size_t size = static_cast<size_t>(this->degree()) + rhs_.data.size();
-    polynomial result(size, Coefficient(0));
-
-    auto coffset = std::cbegin(result);
-    auto offset = std::begin(result);
-    for (const auto &term : data) {
-      if (term) {
-        auto copy = rhs_ * term;
-
-        // std::cout << "  rhs * term = " << rhs << " * " << term << " = " <<
-        // copy
-        // << std::endl;
-        std::transform(std::cbegin(copy), std::cend(copy), coffset, offset,
-                       std::plus<Coefficient>{});
-      }
-      ++coffset;
-      ++offset;
-    }
+    /* leading zeroes do not take part */
+    const size_t lhs_size = static_cast<size_t>(degree()) + 1;
+    const size_t rhs_size = static_cast<size_t>(rhs.degree()) + 1;
+    polynomial result(lhs_size + rhs_size - 1, Coefficient(0));
+
+    /* only operands long enough for Karatsuba need scratch space */
+    std::vector<Coefficient> scratch(
+        kernel::multiply_scratch(lhs_size, rhs_size));
+    kernel::multiply(rep.data(), lhs_size, rhs.rep.data(), rhs_size,
+                     result.rep.data(), scratch.data());
+
     return result;
   }
 
@@ -236,6 +222,11 @@ public:
     return result;
   }
 
+  /* return quotient and remainder */
+  std::pair<polynomial, polynomial> division(const polynomial &rhs) const {
+    return division(*this, rhs);
+  }
+
   polynomial operator/(const polynomial &rhs) const {
     return division(*this, rhs).first;
   }
@@ -258,7 +249,7 @@ public:
   }
 
   polynomial &operator*=(const Coefficient &rhs) {
-    for (auto &&term : data)
+    for (auto &&term : rep)
       term *= rhs;
     return *this;
   }
@@ -267,16 +258,16 @@ public:
     return rhs * lhs;
   }
 
-  bool operator==(const polynomial &rhs) { return data == rhs.data; }
-  bool operator!=(const polynomial &rhs) { return data != rhs.data; }
+  bool operator==(const polynomial &rhs) { return rep == rhs.rep; }
+  bool operator!=(const polynomial &rhs) { return rep != rhs.rep; }
 
   template <typename T> T operator()(const T &x_) const {
-    if (data.empty() || x_ == T(0))
+    if (rep.empty())
       return T(0);
 
-    T result(*std::crbegin(data));
+    T result(*std::crbegin(rep));
 
-    std::for_each(std::crbegin(data) + 1, std::crend(data),
+    std::for_each(std::crbegin(rep) + 1, std::crend(rep),
                   [&](const Coefficient &coefficient) {
       result = (result * x_) + T(coefficient);
     });
@@ -313,23 +304,28 @@ public:
   /* returns polynomial x^n */
   static polynomial n(size_t power) {
     polynomial p(power + 1, Coefficient(0));
-    p.data.back() = Coefficient(1);
+    p.rep.back() = Coefficient(1);
     return p;
   }
 
   template <typename PolyA> static polynomial from(const PolyA &a) {
     polynomial b;
-    b.data.reserve(a.data.size());
+    b.rep.reserve(a.size());
 
-    std::transform(std::cbegin(a.data), std::cend(a.data),
-                   std::back_inserter(b.data),
+    std::transform(std::cbegin(a), std::cend(a),
+                   std::back_inserter(b.rep),
                    [](const auto &e) { return value_type(e); });
 
     return b;
   }
 };
 
-template <typename Coefficient>
-const polynomial<Coefficient> polynomial<Coefficient>::x = { Coefficient(0),
-                                                             Coefficient(1) };
+template <typename Coefficient, typename Container>
+const polynomial<Coefficient, Container>
+    polynomial<Coefficient, Container>::x = { Coefficient(0), Coefficient(1) };
+
+/* Polynomials up to degree MaxDegree without dynamic memory allocation. */
+template <typename Coefficient, size_t MaxDegree>
+using static_polynomial =
+    polynomial<Coefficient, static_vector<Coefficient, MaxDegree + 1> >;
 }
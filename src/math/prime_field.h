@@ -0,0 +1,543 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cassert>
+#include <iterator>
+#include <cstddef>
+#include <stdexcept>
+
+#include "math/galois.h"
+
+namespace math {
+namespace detail {
+
+constexpr bool is_prime(const uint64_t p) {
+  if (p < 2)
+    return false;
+  for (uint64_t d = 2; d * d <= p; d++)
+    if (p % d == 0)
+      return false;
+  return true;
+}
+
+/* p^m, or 0 if p^m exceeds 2^32 */
+constexpr uint64_t field_size(const uint64_t p, const long m) {
+  uint64_t size = 1;
+  for (long i = 0; i < m; i++) {
+    size *= p;
+    if (size > (uint64_t(1) << 32))
+      return 0;
+  }
+  return size;
+}
+
+/* Montgomery arithmetic modulo an odd p < 2^31 with R = 2^32. Residues are
+ * kept in [0, p); the corrections are branch-free. */
+template <uint32_t p> struct montgomery {
+  static_assert(p & 1, "The modulus has to be odd.");
+  static_assert(p < (uint32_t(1) << 31), "The modulus has to be < 2^31.");
+
+  /* -p^-1 mod 2^32 by Newton's iteration; p * p = 1 mod 8 for odd p */
+  static constexpr uint32_t negative_inverse() {
+    uint32_t x = p;
+    for (unsigned i = 0; i < 4; i++)
+      x *= 2 - p * x;
+    return 0 - x;
+  }
+
+  static constexpr uint32_t p_inv = negative_inverse();
+  /* R^2 mod p */
+  static constexpr uint32_t r2 = static_cast<uint32_t>(
+      ((uint64_t(1) << 32) % p) * ((uint64_t(1) << 32) % p) % p);
+
+  /* x - p if x >= p, for x < 2p */
+  static constexpr uint32_t correct(const uint32_t x) noexcept {
+    const uint32_t d = x - p;
+    return d + (p & (0u - (d >> 31)));
+  }
+
+  /* t * R^-1 mod p, for t < p * R */
+  static constexpr uint32_t reduce(const uint64_t t) noexcept {
+    const uint32_t m = static_cast<uint32_t>(t) * p_inv;
+    return correct(static_cast<uint32_t>((t + uint64_t(m) * p) >> 32));
+  }
+
+  static constexpr uint32_t multiply(const uint32_t a,
+                                     const uint32_t b) noexcept {
+    return reduce(uint64_t(a) * b);
+  }
+  static constexpr uint32_t add(const uint32_t a, const uint32_t b) noexcept {
+    return correct(a + b);
+  }
+  static constexpr uint32_t subtract(const uint32_t a,
+                                     const uint32_t b) noexcept {
+    const uint32_t d = a - b;
+    return d + (p & (0u - (d >> 31)));
+  }
+
+  /* x < p into and out of Montgomery form */
+  static constexpr uint32_t to(const uint32_t x) noexcept {
+    return multiply(x, r2);
+  }
+  static constexpr uint32_t from(const uint32_t x) noexcept {
+    return reduce(x);
+  }
+};
+
+template <uint32_t p> constexpr uint32_t montgomery<p>::p_inv;
+template <uint32_t p> constexpr uint32_t montgomery<p>::r2;
+}
+
+/* GF(p^m) for odd primes p < 2^31 and p^m <= 2^32.
+ *
+ * An element is the polynomial c_0 + c_1 x + ... + c_(m-1) x^(m-1) over GF(p)
+ * modulo a primitive polynomial f of degree m; the coefficients are residues
+ * in Montgomery form. For m = 1 this is GF(p) and x is not needed. f is the
+ * first primitive polynomial in the order of storage values and is searched
+ * for on first use, as is a primitive element of GF(p).
+ *
+ * The storage value of an element is its index sum c_i p^i of the canonical
+ * coefficients. Discrete logarithms use a baby-step giant-step search; power()
+ * is therefore more expensive than for the table based fields.
+ */
+template <long Prime, long Power, typename Modular_Polynomial,
+          typename Arithmetic>
+class ef_element {
+  static_assert(Prime > 2 && Prime < (1l << 31),
+                "Only odd primes < 2^31 are supported.");
+  static_assert(detail::is_prime(static_cast<uint64_t>(Prime)),
+                "The characteristic has to be prime.");
+  static_assert(Power > 0, "power must be non-zero.");
+  static_assert(detail::field_size(Prime, Power) != 0,
+                "Only fields with p^m <= 2^32 are supported.");
+  static_assert(Modular_Polynomial::value == 0,
+                "The modular polynomial of GF(p^m) is searched for "
+                "automatically; use modular_polynomial<0>.");
+  static_assert(std::is_same<Arithmetic, gf::montgomery_tag>::value,
+                "Arithmetic must be montgomery_tag.");
+
+  using residue = detail::montgomery<static_cast<uint32_t>(Prime)>;
+  static constexpr uint32_t p = static_cast<uint32_t>(Prime);
+  static constexpr uint64_t size = detail::field_size(Prime, Power);
+  /* number of non-zero elements in the field */
+  static constexpr uint64_t n = size - 1;
+
+public:
+  using storage_type = uint32_t;
+
+private:
+  using element_type = ef_element;
+  /* coefficients c_0 ... c_(m-1) in Montgomery form */
+  using rep_type = std::array<uint32_t, Power>;
+
+  struct context_type {
+    /* x^m = sum r_i x^i mod f */
+    rep_type x_m;
+    rep_type generator;
+  };
+
+  struct ef {
+    /* Iterates over all storage values, the element 0 comes last. The
+     * coefficients are incremented as digits of the storage value. */
+    class const_iterator {
+      uint64_t it;
+      rep_type element;
+
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = ef_element;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const ef_element *;
+      using reference = ef_element;
+
+      const_iterator(const uint64_t it_) noexcept
+          : it(it_), element(ef_element(static_cast<storage_type>(it_ % size),
+                                        gf::unchecked_tag{}).rep) {}
+      ef_element operator*() const noexcept { return ef_element(element); }
+      const_iterator &operator++() noexcept {
+        ++it;
+        for (auto &c : element) {
+          c = residue::add(c, one());
+          if (c)
+            break;
+        }
+        return *this;
+      }
+      const_iterator operator++(int) noexcept {
+        const_iterator copy(*this);
+        ++(*this);
+        return copy;
+      }
+      const_iterator &operator--() noexcept {
+        --it;
+        for (auto &c : element) {
+          const bool borrow = !c;
+          c = residue::subtract(c, one());
+          if (!borrow)
+            break;
+        }
+        return *this;
+      }
+      const_iterator operator--(int) noexcept {
+        const_iterator copy(*this);
+        --(*this);
+        return copy;
+      }
+      bool operator==(const const_iterator &rhs) const noexcept {
+        return it == rhs.it;
+      }
+      bool operator!=(const const_iterator &rhs) const noexcept {
+        return it != rhs.it;
+      }
+    };
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using element_type = ef_element;
+
+    const_iterator begin() const { return cbegin(); }
+    const_iterator end() const { return cend(); }
+    const_iterator cbegin() const noexcept { return const_iterator(1); }
+    const_iterator cend() const noexcept { return const_iterator(size + 1); }
+    const_reverse_iterator rbegin() const { return crbegin(); }
+    const_reverse_iterator rend() const { return crend(); }
+    const_reverse_iterator crbegin() const noexcept {
+      return const_reverse_iterator(cend());
+    }
+    const_reverse_iterator crend() const noexcept {
+      return const_reverse_iterator(cbegin());
+    }
+    friend std::ostream &operator<<(std::ostream &os, const ef &ef) {
+      for (const auto &e : ef) {
+        os << e << "(" << static_cast<storage_type>(e) << ")" << std::endl;
+      }
+      return os;
+    }
+  };
+
+  rep_type rep{};
+
+  explicit ef_element(const rep_type &rep_) noexcept : rep(rep_) {}
+
+  static constexpr uint32_t one() noexcept { return residue::to(1); }
+
+  /* The sums of less than 2m products stay below p * 2^32, the bound of
+   * residue::reduce, so they only have to be reduced once. */
+  static constexpr bool lazy = 2 * uint64_t(Power) * p < (uint64_t(1) << 32);
+
+  static rep_type multiply(const rep_type &a, const rep_type &b,
+                           const rep_type &x_m, std::true_type) noexcept {
+    std::array<uint64_t, 2 * Power - 1> product{};
+    for (size_t i = 0; i < Power; i++)
+      for (size_t j = 0; j < Power; j++)
+        product[i + j] += uint64_t(a[i]) * b[j];
+
+    /* x^i = x^(i - m) * x^m */
+    for (size_t i = 2 * Power - 1; i-- > Power;) {
+      const uint32_t c = residue::reduce(product[i]);
+      for (size_t j = 0; j < Power; j++)
+        product[i - Power + j] += uint64_t(c) * x_m[j];
+    }
+
+    rep_type result;
+    for (size_t i = 0; i < Power; i++)
+      result[i] = residue::reduce(product[i]);
+    return result;
+  }
+
+  static rep_type multiply(const rep_type &a, const rep_type &b,
+                           const rep_type &x_m, std::false_type) noexcept {
+    std::array<uint32_t, 2 * Power - 1> product{};
+    for (size_t i = 0; i < Power; i++)
+      for (size_t j = 0; j < Power; j++)
+        product[i + j] =
+            residue::add(product[i + j], residue::multiply(a[i], b[j]));
+
+    /* x^i = x^(i - m) * x^m */
+    for (size_t i = 2 * Power - 1; i-- > Power;)
+      for (size_t j = 0; j < Power; j++)
+        product[i - Power + j] = residue::add(
+            product[i - Power + j], residue::multiply(product[i], x_m[j]));
+
+    rep_type result;
+    std::copy(std::cbegin(product), std::cbegin(product) + Power,
+              std::begin(result));
+    return result;
+  }
+
+  static rep_type multiply(const rep_type &a, const rep_type &b,
+                           const rep_type &x_m) noexcept {
+    return multiply(a, b, x_m, std::integral_constant<bool, lazy>{});
+  }
+
+  static rep_type pow(rep_type base, uint64_t exponent,
+                      const rep_type &x_m) noexcept {
+    rep_type result{};
+    result[0] = one();
+    for (; exponent; exponent >>= 1) {
+      if (exponent & 1)
+        result = multiply(result, base, x_m);
+      base = multiply(base, base, x_m);
+    }
+    return result;
+  }
+
+  /* prime factors of p^m - 1 */
+  static std::vector<uint64_t> order_factors() {
+    std::vector<uint64_t> factors;
+    uint64_t remainder = n;
+    for (uint64_t q = 2; q * q <= remainder; q++) {
+      if (remainder % q == 0) {
+        factors.push_back(q);
+        while (remainder % q == 0)
+          remainder /= q;
+      }
+    }
+    if (remainder > 1)
+      factors.push_back(remainder);
+    return factors;
+  }
+
+  static bool is_primitive(const rep_type &x, const rep_type &x_m,
+                           const std::vector<uint64_t> &factors) {
+    rep_type unit{};
+    unit[0] = one();
+    if (pow(x, n, x_m) != unit)
+      return false;
+    return std::none_of(std::cbegin(factors), std::cend(factors),
+                        [&](const uint64_t q) {
+      return pow(x, n / q, x_m) == unit;
+    });
+  }
+
+  static context_type init_context() {
+    const auto factors = order_factors();
+    context_type context{};
+
+    if (Power == 1) {
+      /* smallest primitive root modulo p */
+      for (uint32_t g = 2;; g++) {
+        context.generator[0] = residue::to(g);
+        if (is_primitive(context.generator, context.x_m, factors))
+          return context;
+      }
+    }
+
+    /* the first f = x^m + f_(m-1) x^(m-1) + ... + f_0, for which x generates
+     * the multiplicative group; such an f is irreducible. */
+    context.generator[1 % Power] = one();
+    for (uint64_t candidate = 1; candidate < size; candidate++) {
+      const ef_element f(static_cast<storage_type>(candidate),
+                         gf::unchecked_tag{});
+      for (size_t i = 0; i < Power; i++)
+        context.x_m[i] = residue::subtract(0, f.rep[i]);
+      if (is_primitive(context.generator, context.x_m, factors))
+        return context;
+    }
+    throw std::logic_error("No primitive polynomial found.");
+  }
+
+  static const context_type &context() {
+    static const context_type context_ = init_context();
+    return context_;
+  }
+
+  /* (storage value of α^j, j) sorted, j < baby_steps */
+  struct logarithms_type {
+    uint64_t baby_steps;
+    std::vector<std::pair<storage_type, uint64_t> > baby;
+    /* α^(-baby_steps) */
+    rep_type giant;
+  };
+
+  static logarithms_type init_logarithms() {
+    logarithms_type logarithms;
+    uint64_t steps = 1;
+    while (steps * steps < n)
+      steps++;
+    logarithms.baby_steps = steps;
+
+    const ef_element alpha(context().generator);
+    ef_element baby(one_element());
+    logarithms.baby.reserve(steps);
+    for (uint64_t j = 0; j < steps; j++) {
+      logarithms.baby.emplace_back(static_cast<storage_type>(baby), j);
+      baby *= alpha;
+    }
+    std::sort(std::begin(logarithms.baby), std::end(logarithms.baby));
+    logarithms.giant = baby.inverse().rep;
+    return logarithms;
+  }
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+  static const logarithms_type &logarithms() {
+    static const logarithms_type logarithms_ = init_logarithms();
+    return logarithms_;
+  }
+#pragma clang diagnostic pop
+
+  static ef_element one_element() noexcept {
+    rep_type unit{};
+    unit[0] = one();
+    return ef_element(unit);
+  }
+
+public:
+  using field_type = ef;
+  static constexpr size_t digits = Power;
+
+  ef_element() = default;
+  /* Validates v; use this constructor for values from outside the field. */
+  explicit ef_element(const storage_type &v)
+      : ef_element(v, gf::unchecked_tag{}) {
+    if (v > n)
+      throw std::runtime_error("Value is not an element of the field.");
+  }
+  /* Skips the validation; v still has to be converted into the coefficient
+   * representation. */
+  ef_element(storage_type v, gf::unchecked_tag) noexcept {
+    for (auto &c : rep) {
+      c = residue::to(static_cast<uint32_t>(v % p));
+      v /= p;
+    }
+  }
+
+  static ef_element from_power(unsigned power) {
+    if (Power == 1)
+      return ef_element(pow(context().generator, power % n, rep_type{}));
+    return ef_element(pow(context().generator, power % n, context().x_m));
+  }
+
+  unsigned power() const {
+    if (!*this)
+      return 0;
+
+    const logarithms_type &logarithms_ = logarithms();
+    const ef_element giant(logarithms_.giant);
+    ef_element x(*this);
+    for (uint64_t i = 0; i <= logarithms_.baby_steps; i++) {
+      const auto key = static_cast<storage_type>(x);
+      const auto it = std::lower_bound(std::cbegin(logarithms_.baby),
+                                       std::cend(logarithms_.baby),
+                                       std::make_pair(key, uint64_t(0)));
+      if (it != std::cend(logarithms_.baby) && it->first == key)
+        return static_cast<unsigned>((i * logarithms_.baby_steps + it->second) %
+                                     n);
+      x *= giant;
+    }
+    throw std::logic_error("Discrete logarithm not found.");
+  }
+
+  ef_element operator+(const ef_element &rhs) const noexcept {
+    rep_type result;
+    for (size_t i = 0; i < Power; i++)
+      result[i] = residue::add(rep[i], rhs.rep[i]);
+    return ef_element(result);
+  }
+
+  ef_element operator-(const ef_element &rhs) const noexcept {
+    rep_type result;
+    for (size_t i = 0; i < Power; i++)
+      result[i] = residue::subtract(rep[i], rhs.rep[i]);
+    return ef_element(result);
+  }
+
+  ef_element operator-() const noexcept { return ef_element() - *this; }
+
+  ef_element operator*(const ef_element &rhs) const {
+    if (Power == 1)
+      return ef_element(rep_type{ { residue::multiply(rep[0], rhs.rep[0]) } });
+    return ef_element(multiply(rep, rhs.rep, context().x_m));
+  }
+
+  /* Division by zero is a precondition violation. */
+  ef_element operator/(const ef_element &rhs) const {
+    assert(rhs);
+    return *this * rhs.inverse();
+  }
+
+  /* x^(p^m - 2) */
+  ef_element inverse() const {
+    assert(*this);
+    if (Power == 1)
+      return ef_element(pow(rep, n - 1, rep_type{}));
+    return ef_element(pow(rep, n - 1, context().x_m));
+  }
+
+  ef_element &operator*=(const ef_element &rhs) {
+    *this = *this * rhs;
+    return *this;
+  }
+
+  ef_element &operator+=(const ef_element &rhs) noexcept {
+    *this = *this + rhs;
+    return *this;
+  }
+
+  ef_element &operator-=(const ef_element &rhs) noexcept {
+    *this = *this - rhs;
+    return *this;
+  }
+
+  ef_element &operator++() noexcept {
+    *this = *this + one_element();
+    return *this;
+  }
+
+  ef_element operator++(int) noexcept {
+    ef_element result(*this);
+    ++(*this);
+    return result;
+  }
+
+  bool operator<(const ef_element &rhs) const {
+    /* x < 0 is false */
+    if (!rhs)
+      return false;
+    /* 0 < !0 is true */
+    if (!*this)
+      return true;
+    /* sort by power */
+    return power() < rhs.power();
+  }
+  bool operator!=(const ef_element &rhs) const noexcept {
+    return rep != rhs.rep;
+  }
+  bool operator==(const ef_element &rhs) const noexcept {
+    return rep == rhs.rep;
+  }
+
+  explicit operator bool() const noexcept {
+    return std::any_of(std::cbegin(rep), std::cend(rep),
+                       [](const uint32_t c) { return c != 0; });
+  }
+  explicit operator storage_type() const noexcept {
+    storage_type value = 0;
+    for (size_t i = Power; i--;)
+      value = value * p + residue::from(rep[i]);
+    return value;
+  }
+  explicit operator unsigned long() const noexcept {
+    return static_cast<storage_type>(*this);
+  }
+  explicit operator unsigned long long() const noexcept {
+    return static_cast<storage_type>(*this);
+  }
+  explicit operator int() const noexcept {
+    return static_cast<int>(static_cast<storage_type>(*this));
+  }
+  explicit operator float() const noexcept {
+    return static_cast<float>(static_cast<storage_type>(*this));
+  }
+
+  /* elements of GF(p) are printed as integers */
+  friend std::ostream &operator<<(std::ostream &os, const ef_element &e) {
+    if (Power == 1 || !e)
+      return os << static_cast<storage_type>(e);
+    else
+      return os << "α^" << e.power();
+  }
+};
+}
@@ -0,0 +1,612 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "math/additive_fft.h"
+#include "math/kernels.h"
+#include "math/static_vector.h"
+
+namespace math {
+
+namespace gf {
+
+struct brute_force_tag {};
+struct chien_tag {};
+struct closed_form_tag {};
+struct berlekamp_trace_tag {};
+struct additive_fft_tag {};
+
+template <typename Field, typename Coefficient = typename Field::element_type,
+          typename Result = std::vector<Coefficient>, typename Polynomial>
+Result roots(const Polynomial &p, brute_force_tag) {
+  /* I need a type for the variable x, it has not necessarily something to do
+   * with the coefficient type */
+  Result zeroes;
+  /* a non-zero p has at most deg(p) zeroes */
+  const auto degree = p.degree();
+
+  for (const auto &element : Field{}) {
+    if (degree >= 0 && zeroes.size() == static_cast<size_t>(degree))
+      break;
+    if (element && !p(element))
+      zeroes.push_back(element);
+  }
+  return zeroes;
+}
+
+namespace detail {
+/* Registers of the Chien search. They are reused by later searches of the
+ * same thread, so that the search does not allocate memory after the first
+ * one. */
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+template <typename T> std::vector<T> &chien_registers() {
+  static thread_local std::vector<T> registers;
+  return registers;
+}
+#pragma clang diagnostic pop
+
+/* number of non-zero elements of the field of Element */
+template <typename Element> struct multiplicative_order;
+template <long Prime, long Power, typename Mp, typename A>
+struct multiplicative_order<ef_element<Prime, Power, Mp, A> >
+    : std::integral_constant<
+          uint64_t, Prime == 2 ? (Power == 64 ? ~uint64_t(0)
+                                              : (uint64_t(1) << Power) - 1)
+                               : math::detail::field_size(Prime, Power) - 1> {};
+
+/* One register per coefficient: r_j = p_j α^(ij) at step i, so that p(α^i) is
+ * the sum of the registers and the next step multiplies r_j by α^j. */
+template <typename Element, typename Result, typename Polynomial>
+Result chien(const Polynomial &p, const size_t degree, std::false_type) {
+  /* register and the constant it is multiplied by in every step */
+  auto &registers = chien_registers<std::pair<Element, Element> >();
+  registers.clear();
+  auto coefficient = std::cbegin(p);
+  for (size_t j = 0; j <= degree; j++, ++coefficient)
+    registers.emplace_back(Element(*coefficient),
+                           Element::from_power(static_cast<unsigned>(j)));
+
+  Result zeroes;
+  for (uint64_t i = 0; i < multiplicative_order<Element>::value; i++) {
+    Element sum(0);
+    for (auto &register_ : registers) {
+      sum = sum + register_.first;
+      register_.first = register_.first * register_.second;
+    }
+    if (!sum) {
+      zeroes.push_back(Element::from_power(static_cast<unsigned>(i)));
+      if (zeroes.size() == degree)
+        break;
+    }
+  }
+  return zeroes;
+}
+
+/* lanes consecutive powers are evaluated per step: register j holds
+ * p_j α^(j(i + l)) for l < lanes and is multiplied by the constant α^(j lanes)
+ * in every step, which the split tables do a vector at a time. */
+template <typename Element, typename Result, typename Polynomial>
+Result chien(const Polynomial &p, const size_t degree, std::true_type) {
+  constexpr size_t lanes = 32;
+  constexpr uint64_t n = multiplicative_order<Element>::value;
+
+  auto &registers = chien_registers<Element>();
+  registers.resize(lanes * (degree + 1));
+  auto &steps = chien_registers<kernel::multiplier<Element> >();
+  steps.clear();
+
+  auto coefficient = std::cbegin(p);
+  for (size_t j = 0; j <= degree; j++, ++coefficient) {
+    const Element alpha_j = Element::from_power(static_cast<unsigned>(j));
+    Element *lane = registers.data() + j * lanes;
+    lane[0] = Element(*coefficient);
+    for (size_t l = 1; l < lanes; l++)
+      lane[l] = lane[l - 1] * alpha_j;
+    steps.emplace_back(
+        Element::from_power(static_cast<unsigned>((j * lanes) % n)));
+  }
+
+  Result zeroes;
+  Element sums[lanes];
+  for (uint64_t i = 0; i < n; i += lanes) {
+    std::copy(registers.data(), registers.data() + lanes, sums);
+    for (size_t j = 1; j <= degree; j++) {
+      Element *lane = registers.data() + j * lanes;
+      for (size_t l = 0; l < lanes; l++)
+        sums[l] = sums[l] + lane[l];
+      steps[j].scale(lane, lane + lanes);
+    }
+
+    const size_t valid = static_cast<size_t>(
+        std::min<uint64_t>(lanes, n - i));
+    for (size_t l = 0; l < valid; l++) {
+      if (sums[l])
+        continue;
+      zeroes.push_back(Element::from_power(static_cast<unsigned>(i + l)));
+      if (zeroes.size() == degree)
+        return zeroes;
+    }
+  }
+  return zeroes;
+}
+}
+
+/* Chien search: evaluates p at α^0, α^1, ..., α^(n - 1) incrementally, i.e.
+ * with one multiplication by a constant per coefficient and power instead of
+ * Horner's method, and stops after deg(p) zeroes. Fields with split tables
+ * evaluate several powers at once. Like the brute-force search, 0 is not
+ * tested. */
+template <typename Field, typename Coefficient = typename Field::element_type,
+          typename Result = std::vector<Coefficient>, typename Polynomial>
+Result roots(const Polynomial &p, chien_tag) {
+  using Element = typename Field::element_type;
+
+  const auto degree = p.degree();
+  /* every element is a zero of the zero polynomial */
+  if (degree < 0)
+    return roots<Field, Coefficient, Result>(p, brute_force_tag{});
+  if (degree == 0)
+    return Result();
+
+  return detail::chien<Element, Result>(
+      p, static_cast<size_t>(degree),
+      typename kernel::detail::is_split_table_field<Element>::type());
+}
+
+namespace detail {
+template <typename Element> struct is_binary_field : std::false_type {};
+template <long Power, typename Mp, typename A>
+struct is_binary_field<ef_element<2, Power, Mp, A> > : std::true_type {};
+
+/* GF(2^m) as vector space over GF(2): addition is the XOR of the storage
+ * values, so bit i of the storage value is the coordinate of the basis element
+ * with storage value 2^i. */
+template <typename Element> uint64_t coordinates(const Element &e) noexcept {
+  return static_cast<uint64_t>(
+      static_cast<typename Element::storage_type>(e));
+}
+
+template <typename Element> Element from_coordinates(const uint64_t v) noexcept {
+  return Element(static_cast<typename Element::storage_type>(v),
+                 gf::unchecked_tag{});
+}
+
+/* L(x) = c for a GF(2)-linear map L of GF(2^m), given by the images of the
+ * basis. Gauss-Jordan elimination leaves every pivot bit in exactly one row,
+ * so a solution is the sum of the preimages of the pivot bits of c. The
+ * solutions are x + ker L. */
+class linear_map {
+  std::array<uint64_t, 64> images{};
+  std::array<uint64_t, 64> preimages{};
+  std::array<uint64_t, 64> kernel_{};
+  size_t dimension = 0;
+
+public:
+  template <typename InputIt> linear_map(InputIt image, const size_t m) {
+    std::array<unsigned, 64> pivots;
+    size_t rows = 0;
+    for (size_t i = 0; i < m; i++, ++image) {
+      uint64_t v = *image;
+      uint64_t p = uint64_t(1) << i;
+      for (size_t row = 0; row < rows; row++) {
+        if ((v >> pivots[row]) & 1) {
+          v ^= images[row];
+          p ^= preimages[row];
+        }
+      }
+      if (!v) {
+        kernel_[dimension++] = p;
+        continue;
+      }
+
+      const unsigned pivot = 63 - static_cast<unsigned>(__builtin_clzll(v));
+      for (size_t row = 0; row < rows; row++) {
+        if ((images[row] >> pivot) & 1) {
+          images[row] ^= v;
+          preimages[row] ^= p;
+        }
+      }
+      pivots[rows] = pivot;
+      images[rows] = v;
+      preimages[rows++] = p;
+    }
+
+    /* index by pivot bit */
+    std::array<uint64_t, 64> by_bit_images{};
+    std::array<uint64_t, 64> by_bit_preimages{};
+    for (size_t row = 0; row < rows; row++) {
+      by_bit_images[pivots[row]] = images[row];
+      by_bit_preimages[pivots[row]] = preimages[row];
+    }
+    images = by_bit_images;
+    preimages = by_bit_preimages;
+  }
+
+  /* returns false if c is not in the image of L */
+  bool solve(uint64_t c, uint64_t &x) const noexcept {
+    uint64_t image = 0;
+    x = 0;
+    for (uint64_t bits = c; bits; bits &= bits - 1) {
+      const auto bit = static_cast<size_t>(__builtin_ctzll(bits));
+      image ^= images[bit];
+      x ^= preimages[bit];
+    }
+    return image == c;
+  }
+
+  size_t kernel_dimension() const noexcept { return dimension; }
+  uint64_t kernel(const size_t i) const noexcept { return kernel_[i]; }
+};
+
+/* y^2 + y = c for all c of the field, computed once. For odd m the preimages
+ * are the half-traces of the basis. */
+template <typename Element> const linear_map &quadratic_map() {
+  static const linear_map map = [] {
+    std::array<uint64_t, 64> images;
+    for (size_t i = 0; i < Element::digits; i++) {
+      const Element e = from_coordinates<Element>(uint64_t(1) << i);
+      images[i] = coordinates(e * e + e);
+    }
+    return linear_map(std::cbegin(images), Element::digits);
+  }();
+  return map;
+}
+
+template <typename Element> Element square_root(Element e) noexcept {
+  /* e^(2^m) = e */
+  for (size_t i = 1; i < Element::digits; i++)
+    e = e * e;
+  return e;
+}
+
+template <typename Element, typename Result>
+void add_zero(Result &zeroes, const Element *p, const size_t degree,
+              const Element &x) {
+  if (!x)
+    return;
+  if (std::find(std::cbegin(zeroes), std::cend(zeroes), x) !=
+      std::cend(zeroes))
+    return;
+  Element y(0);
+  for (size_t i = degree + 1; i--;)
+    y = y * x + p[i];
+  if (!y)
+    zeroes.push_back(x);
+}
+
+/* x^4 + a x^2 + b x = c; the left side is GF(2)-linear in x. Returns the up to
+ * four solutions in candidates. */
+template <typename Element>
+size_t affine_solutions(const Element &a, const Element &b, const Element &c,
+                        std::array<Element, 4> &candidates) {
+  std::array<uint64_t, 64> images;
+  for (size_t i = 0; i < Element::digits; i++) {
+    const Element e = from_coordinates<Element>(uint64_t(1) << i);
+    const Element e2 = e * e;
+    images[i] = coordinates(e2 * e2 + a * e2 + b * e);
+  }
+
+  const linear_map map(std::cbegin(images), Element::digits);
+  uint64_t x;
+  if (!map.solve(coordinates(c), x))
+    return 0;
+  /* a non-zero affine polynomial of degree 4 has at most 4 zeroes */
+  const size_t dimension = std::min<size_t>(map.kernel_dimension(), 2);
+  const size_t solutions = size_t(1) << dimension;
+  for (size_t i = 0; i < solutions; i++) {
+    uint64_t v = x;
+    for (size_t k = 0; k < dimension; k++) {
+      if ((i >> k) & 1)
+        v ^= map.kernel(k);
+    }
+    candidates[i] = from_coordinates<Element>(v);
+  }
+  return solutions;
+}
+
+/* Zeroes of a monic polynomial p of degree 1 to 4 with p(0) != 0 over GF(2^m).
+ * Candidates are verified, so p need not split. */
+template <typename Element, typename Result>
+void closed_form(const Element *p, const size_t degree, Result &zeroes) {
+  std::array<Element, 4> candidates;
+  size_t count = 0;
+
+  switch (degree) {
+  case 1:
+    candidates[count++] = p[0];
+    break;
+  case 2: {
+    /* x = b y: b^2 (y^2 + y) = c */
+    const Element &b = p[1];
+    const Element &c = p[0];
+    if (!b) {
+      candidates[count++] = square_root(c);
+      break;
+    }
+    uint64_t y;
+    if (quadratic_map<Element>().solve(coordinates(c / (b * b)), y)) {
+      candidates[count++] = b * from_coordinates<Element>(y);
+      candidates[count++] = b * from_coordinates<Element>(y ^ 1);
+    }
+    break;
+  }
+  case 3: {
+    /* (x^3 + b x^2 + c x + d)(x + b) = x^4 + (b^2 + c) x^2 + (bc + d) x + bd */
+    const Element &b = p[2];
+    const Element &c = p[1];
+    const Element &d = p[0];
+    count = affine_solutions(b * b + c, b * c + d, b * d, candidates);
+    break;
+  }
+  case 4: {
+    const Element &a3 = p[3];
+    if (!a3) {
+      count = affine_solutions(p[2], p[1], p[0], candidates);
+      break;
+    }
+    /* x = y + w with w^2 = a1 / a3 removes the linear term:
+     * y^4 + a3 y^3 + (a3 w + a2) y^2 + p(w) */
+    const Element w = square_root(p[1] / a3);
+    const Element b2 = a3 * w + p[2];
+    Element b0(0);
+    for (size_t i = degree + 1; i--;)
+      b0 = b0 * w + p[i];
+
+    if (!b0) {
+      /* y (y^3 + a3 y^2 + b2 y) = y^2 (y^2 + a3 y + b2) */
+      const std::array<Element, 3> q{ { b2, a3, Element(1) } };
+      Result quadratic;
+      candidates[count++] = w;
+      closed_form(q.data(), 2, quadratic);
+      for (const auto &y : quadratic)
+        candidates[count++] = y + w;
+      break;
+    }
+
+    /* y = 1 / z: z^4 + (b2 / b0) z^2 + (a3 / b0) z + 1 / b0 */
+    const Element inverse = Element(1) / b0;
+    count = affine_solutions(b2 * inverse, a3 * inverse, inverse, candidates);
+    for (size_t i = 0; i < count; i++)
+      candidates[i] = Element(1) / candidates[i] + w;
+    break;
+  }
+  default:
+    throw std::logic_error("Closed form zeroes need a degree of 1 to 4.");
+  }
+
+  for (size_t i = 0; i < count; i++)
+    add_zero(zeroes, p, degree, candidates[i]);
+}
+
+/* Coefficients of p in the search field, lowest degree first, without the
+ * factor x^k and normalized to a leading one. */
+template <typename Element, typename Container, typename Polynomial>
+void monic_coefficients(const Polynomial &p, const size_t degree,
+                        Container &f) {
+  f.reserve(degree + 1);
+  auto coefficient = std::cbegin(p);
+  for (size_t i = 0; i <= degree; i++, ++coefficient) {
+    if (f.empty() && !Element(*coefficient))
+      continue;
+    f.push_back(Element(*coefficient));
+  }
+  kernel::scale(f.data(), f.data() + f.size(), Element(1) / f.back());
+}
+
+/* Polynomial arithmetic over GF(2^m) on coefficient vectors, lowest degree
+ * first, for the Berlekamp trace algorithm. */
+template <typename Element> void trim(std::vector<Element> &a) {
+  while (!a.empty() && !a.back())
+    a.pop_back();
+}
+
+/* a = a mod f for a monic f */
+template <typename Element>
+void reduce(std::vector<Element> &a, const std::vector<Element> &f) {
+  trim(a);
+  const size_t k = f.size() - 1;
+  for (size_t i = a.size(); i-- > k;) {
+    const Element c = a[i];
+    kernel::axpy(a.data() + i - k, a.data() + i, f.data(), c);
+    a[i] = Element(0);
+  }
+  trim(a);
+}
+
+/* monic gcd(a, b) */
+template <typename Element>
+std::vector<Element> gcd(std::vector<Element> a, std::vector<Element> b) {
+  trim(a);
+  trim(b);
+  while (!b.empty()) {
+    kernel::scale(b.data(), b.data() + b.size(), Element(1) / b.back());
+    reduce(a, b);
+    std::swap(a, b);
+  }
+  kernel::scale(a.data(), a.data() + a.size(), Element(1) / a.back());
+  return a;
+}
+
+/* f / g for a monic g dividing f */
+template <typename Element>
+std::vector<Element> quotient(std::vector<Element> f,
+                              const std::vector<Element> &g) {
+  const size_t k = g.size() - 1;
+  std::vector<Element> q(f.size() - k);
+  for (size_t i = f.size(); i-- > k;) {
+    const Element c = f[i];
+    q[i - k] = c;
+    kernel::axpy(f.data() + i - k, f.data() + i, g.data(), c);
+  }
+  return q;
+}
+
+/* a^2 mod f; squaring is linear in characteristic 2 */
+template <typename Element>
+std::vector<Element> square(const std::vector<Element> &a,
+                            const std::vector<Element> &f) {
+  std::vector<Element> s(a.empty() ? 0 : 2 * a.size() - 1, Element(0));
+  for (size_t i = 0; i < a.size(); i++)
+    s[2 * i] = a[i] * a[i];
+  reduce(s, f);
+  return s;
+}
+
+/* Splits a product f of distinct linear factors with gcd(f, Tr(βx)) for the
+ * basis elements β starting at beta. residues[j] = x^(2^j) mod f. */
+template <typename Element, typename Result>
+void trace_split(const std::vector<Element> &f,
+                 std::vector<std::vector<Element> > residues, size_t beta,
+                 Result &zeroes) {
+  const size_t degree = f.size() - 1;
+  if (degree <= 4) {
+    closed_form(f.data(), degree, zeroes);
+    return;
+  }
+
+  for (; beta < Element::digits; beta++) {
+    /* Tr(βx) = sum of (βx)^(2^j) */
+    std::vector<Element> trace(degree, Element(0));
+    Element b = from_coordinates<Element>(uint64_t(1) << beta);
+    for (const auto &residue : residues) {
+      kernel::axpy(trace.data(), trace.data() + residue.size(), residue.data(),
+                   b);
+      b = b * b;
+    }
+
+    const auto g = gcd(f, trace);
+    const size_t k = g.size() - 1;
+    if (k == 0 || k == degree)
+      continue;
+
+    const auto h = quotient(f, g);
+    auto residues_h = residues;
+    for (auto &residue : residues)
+      reduce(residue, g);
+    for (auto &residue : residues_h)
+      reduce(residue, h);
+    trace_split(g, std::move(residues), beta + 1, zeroes);
+    trace_split(h, std::move(residues_h), beta + 1, zeroes);
+    return;
+  }
+  /* distinct zeroes differ in the trace of some βx */
+  throw std::logic_error("Polynomial does not split into distinct factors.");
+}
+}
+
+/* Zeroes of polynomials of degree up to 4 over GF(2^m) without a search:
+ * quadratics are solved as y^2 + y = c with a precomputed table, cubics and
+ * quartics as affine polynomials x^4 + a x^2 + b x = c, i.e. a linear equation
+ * system over GF(2). Higher degrees are searched with chien_tag. */
+template <typename Field, typename Coefficient = typename Field::element_type,
+          typename Result = std::vector<Coefficient>, typename Polynomial>
+Result roots(const Polynomial &p, closed_form_tag) {
+  using Element = typename Field::element_type;
+  static_assert(detail::is_binary_field<Element>::value,
+                "Closed form zeroes are implemented for GF(2^m).");
+
+  const auto degree = p.degree();
+  if (degree > 4 || degree < 0)
+    return roots<Field, Coefficient, Result>(p, chien_tag{});
+
+  Result zeroes;
+  if (degree == 0)
+    return zeroes;
+  static_vector<Element, 5> f;
+  detail::monic_coefficients<Element>(p, static_cast<size_t>(degree), f);
+  if (f.size() > 1)
+    detail::closed_form(f.data(), f.size() - 1, zeroes);
+  return zeroes;
+}
+
+/* Berlekamp trace algorithm over GF(2^m): gcd(f, x^(2^m) - x) keeps the
+ * distinct linear factors of f, which are split by gcd(f, Tr(βx)) for the
+ * basis elements β until the closed form applies. Costs O(m deg(f)^2) instead
+ * of O(n deg(f)) for the Chien search. */
+template <typename Field, typename Coefficient = typename Field::element_type,
+          typename Result = std::vector<Coefficient>, typename Polynomial>
+Result roots(const Polynomial &p, berlekamp_trace_tag) {
+  using Element = typename Field::element_type;
+  static_assert(detail::is_binary_field<Element>::value,
+                "The Berlekamp trace algorithm is implemented for GF(2^m).");
+
+  const auto degree = p.degree();
+  if (degree <= 4)
+    return roots<Field, Coefficient, Result>(p, closed_form_tag{});
+
+  Result zeroes;
+  std::vector<Element> f;
+  detail::monic_coefficients<Element>(p, static_cast<size_t>(degree), f);
+  if (f.size() == 1)
+    return zeroes;
+  if (f.size() <= 5) {
+    detail::closed_form(f.data(), f.size() - 1, zeroes);
+    return zeroes;
+  }
+
+  /* x^(2^j) mod f for j = 0, ..., m */
+  std::vector<std::vector<Element> > residues;
+  residues.reserve(Element::digits + 1);
+  residues.push_back({ Element(0), Element(1) });
+  for (size_t j = 0; j < Element::digits; j++)
+    residues.push_back(detail::square(residues.back(), f));
+
+  auto x = residues.back();
+  x.resize(std::max<size_t>(x.size(), 2), Element(0));
+  x[1] = x[1] + Element(1);
+  const auto g = detail::gcd(f, x);
+  if (g.size() == 1)
+    return zeroes;
+
+  residues.pop_back();
+  if (g.size() < f.size()) {
+    for (auto &residue : residues)
+      detail::reduce(residue, g);
+  }
+  detail::trace_split(g, std::move(residues), 0, zeroes);
+  return zeroes;
+}
+
+/* Evaluates p at all elements of GF(2^m) at once with the additive FFT and
+ * collects the zeroes. */
+template <typename Field, typename Coefficient = typename Field::element_type,
+          typename Result = std::vector<Coefficient>, typename Polynomial>
+Result roots(const Polynomial &p, additive_fft_tag) {
+  using Element = typename Field::element_type;
+  static_assert(detail::is_binary_field<Element>::value,
+                "The additive FFT is implemented for GF(2^m).");
+
+  const auto degree = p.degree();
+  if (degree < 0)
+    return roots<Field, Coefficient, Result>(p, brute_force_tag{});
+
+  Result zeroes;
+  if (degree == 0)
+    return zeroes;
+
+  std::vector<Element> f;
+  f.reserve(static_cast<size_t>(degree) + 1);
+  auto coefficient = std::cbegin(p);
+  for (ssize_t i = 0; i <= degree; i++, ++coefficient)
+    f.push_back(Element(*coefficient));
+
+  const auto values = additive_fft(f.data(), f.data() + f.size());
+  for (size_t i = 1; i < values.size(); i++) {
+    if (values[i])
+      continue;
+    zeroes.push_back(detail::from_coordinates<Element>(i));
+    if (zeroes.size() == static_cast<size_t>(degree))
+      break;
+  }
+  return zeroes;
+}
+}
+}
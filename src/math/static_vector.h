@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <initializer_list>
+#include <stdexcept>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+namespace math {
+
+/* A vector with a fixed capacity and the storage in place, i.e. on the stack
+ * for automatic variables. Provides the subset of the std::vector interface
+ * needed by polynomials and decoders. Exceeding the capacity throws
+ * std::length_error.
+ *
+ * Only the first size() elements are initialized and copied, so constructing
+ * and copying costs O(size()) and not O(Capacity). */
+template <typename T, size_t Capacity> class static_vector {
+  static_assert(std::is_trivially_destructible<T>::value,
+                "static_vector only holds trivially destructible types.");
+
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type
+      elements[Capacity];
+  size_t size_ = 0;
+
+  void check_capacity(const size_t count) const {
+    if (count > Capacity)
+      throw std::length_error("static_vector capacity exceeded.");
+  }
+
+public:
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T &;
+  using const_reference = const T &;
+  using pointer = T *;
+  using const_pointer = const T *;
+  using iterator = T *;
+  using const_iterator = const T *;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  static_vector() noexcept {}
+  static_vector(size_type count, const T &value) : size_(count) {
+    check_capacity(count);
+    std::uninitialized_fill_n(begin(), count, value);
+  }
+  explicit static_vector(size_type count) : static_vector(count, T()) {}
+  static_vector(std::initializer_list<T> il) : size_(il.size()) {
+    check_capacity(il.size());
+    std::uninitialized_copy(std::begin(il), std::end(il), begin());
+  }
+  template <typename InputIt,
+            typename = typename std::iterator_traits<InputIt>::value_type>
+  static_vector(InputIt first, InputIt last) {
+    for (; first != last; ++first)
+      push_back(*first);
+  }
+  static_vector(const static_vector &other) : size_(other.size_) {
+    std::uninitialized_copy(other.begin(), other.end(), begin());
+  }
+  /* Elements are trivially destructible, so they can be overwritten. */
+  static_vector &operator=(const static_vector &other) {
+    if (this != &other) {
+      size_ = other.size_;
+      std::uninitialized_copy(other.begin(), other.end(), begin());
+    }
+    return *this;
+  }
+
+  iterator begin() noexcept { return data(); }
+  iterator end() noexcept { return data() + size_; }
+  const_iterator begin() const noexcept { return data(); }
+  const_iterator end() const noexcept { return data() + size_; }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+  const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+  const_reverse_iterator crend() const noexcept { return rend(); }
+
+  size_type size() const noexcept { return size_; }
+  static constexpr size_type capacity() noexcept { return Capacity; }
+  bool empty() const noexcept { return size_ == 0; }
+  void reserve(size_type new_capacity) const { check_capacity(new_capacity); }
+
+  T *data() noexcept { return reinterpret_cast<T *>(elements); }
+  const T *data() const noexcept {
+    return reinterpret_cast<const T *>(elements);
+  }
+
+  reference operator[](size_type i) noexcept { return data()[i]; }
+  const_reference operator[](size_type i) const noexcept {
+    return data()[i];
+  }
+  reference at(size_type i) {
+    if (i >= size_)
+      throw std::out_of_range("static_vector index out of range.");
+    return data()[i];
+  }
+  const_reference at(size_type i) const {
+    if (i >= size_)
+      throw std::out_of_range("static_vector index out of range.");
+    return data()[i];
+  }
+  reference front() noexcept { return data()[0]; }
+  const_reference front() const noexcept { return data()[0]; }
+  reference back() noexcept { return data()[size_ - 1]; }
+  const_reference back() const noexcept { return data()[size_ - 1]; }
+
+  void push_back(const T &value) {
+    check_capacity(size_ + 1);
+    new (data() + size_++) T(value);
+  }
+  void push_back(T &&value) {
+    check_capacity(size_ + 1);
+    new (data() + size_++) T(std::move(value));
+  }
+  template <typename... Args> void emplace_back(Args &&... args) {
+    push_back(T(std::forward<Args>(args)...));
+  }
+  void pop_back() noexcept { --size_; }
+  void resize(size_type count, const T &value = T()) {
+    check_capacity(count);
+    if (count > size_)
+      std::uninitialized_fill(end(), begin() + count, value);
+    size_ = count;
+  }
+  void clear() noexcept { size_ = 0; }
+  iterator erase(const_iterator first, const_iterator last) {
+    iterator first_ = begin() + (first - cbegin());
+    iterator last_ = begin() + (last - cbegin());
+    std::move(last_, end(), first_);
+    size_ -= static_cast<size_type>(last_ - first_);
+    return first_;
+  }
+
+  friend bool operator==(const static_vector &lhs, const static_vector &rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+  friend bool operator!=(const static_vector &lhs, const static_vector &rhs) {
+    return !(lhs == rhs);
+  }
+};
+}
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <utility>
+#include <cassert>
+#include <iterator>
+#include <cstddef>
+
+#include "math/galois.h"
+
+namespace math {
+
+/* GF(2^Power) = GF(2^k)[y] / (y^2 + y + β), k = Power / 2.
+ *
+ * An element a + b * y is stored as a | b << k. The field is represented by
+ * pairs of elements of GF(2^k), so that multiplication and inversion only use
+ * the log/exp tables of GF(2^k), which stay in the cache, instead of tables of
+ * 2^Power entries. Modular_Polynomial::value is β; y^2 + y + β is irreducible
+ * iff Tr(β) = 1.
+ *
+ * The conjugate of y is y^(2^k) = y + 1, hence
+ *   (a + b * y)(c + d * y) = (ac + βbd) + ((a + b)(c + d) + ac) * y
+ *   N(a + b * y) = (a + b * y)^(2^k + 1) = a^2 + ab + βb^2
+ *   1 / (a + b * y) = ((a + b) + b * y) / N(a + b * y)
+ *
+ * Discrete logarithms are computed from the logarithm of the norm in GF(2^k)
+ * and a baby-step giant-step search in the subgroup of order 2^k + 1; both
+ * are combined by the CRT. power() and from_power() are therefore more
+ * expensive than for the table based fields.
+ */
+template <long Power, typename Modular_Polynomial>
+class ef_element<2, Power, Modular_Polynomial, gf::tower_tag> {
+  static_assert(Power % 2 == 0, "Tower fields need an even power.");
+  static_assert(Power <= 32, "Only power <= 32 are supported.");
+
+  static constexpr unsigned k = Power / 2;
+  static constexpr uint64_t size = uint64_t(1) << Power;
+  /* number of non-zero elements in the field */
+  static constexpr uint64_t n = size - 1;
+  /* orders of GF(2^k)* and of the norm-1 subgroup */
+  static constexpr uint64_t base_order = (uint64_t(1) << k) - 1;
+  static constexpr uint64_t norm_order = (uint64_t(1) << k) + 1;
+
+  using base_polynomial = typename detail::default_modular_polynomial<k>::type;
+
+  static_assert(detail::trace(Modular_Polynomial::value, k,
+                              base_polynomial::value) == 1,
+                "y^2 + y + β has to be irreducible, i.e. Tr(β) = 1.");
+
+public:
+  using storage_type = typename detail::uint_t<Power>::type;
+  using base_type = ef_element<2, k, base_polynomial, gf::log_table_tag>;
+
+private:
+  using base_storage = typename base_type::storage_type;
+  using element_type = ef_element;
+
+  /* ceil(sqrt(2^k + 1)) at most */
+  static constexpr size_t baby_steps = (size_t(1) << ((k + 1) / 2)) + 1;
+  static constexpr size_t power_digits = (Power + 7) / 8;
+
+  /* Generator and discrete logarithm tables. They depend on arithmetic, which
+   * is not constexpr and are computed on first use. */
+  struct tables_type {
+    /* powers[j][i] = α^(i * 256^j) */
+    std::array<std::array<storage_type, 256>, power_digits> powers;
+    /* (γ^j, j) sorted by γ^j, γ = α^(2^k - 1) generates the norm-1 group */
+    std::array<std::pair<storage_type, uint32_t>, baby_steps> baby;
+    /* γ^(-baby_steps) */
+    storage_type giant;
+    /* inverse of log(N(α)) mod 2^k - 1 */
+    uint64_t norm_log_inverse;
+  };
+
+  struct ef {
+    /* Iterates over all storage values, the element 0 comes last. */
+    class const_iterator {
+      uint64_t it;
+
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = ef_element;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const ef_element *;
+      using reference = ef_element;
+
+      constexpr explicit const_iterator(const uint64_t it_) noexcept
+          : it(it_) {}
+      constexpr ef_element operator*() const noexcept {
+        return ef_element(static_cast<storage_type>(it & n),
+                          gf::unchecked_tag{});
+      }
+      const_iterator &operator++() noexcept {
+        ++it;
+        return *this;
+      }
+      const_iterator operator++(int) noexcept {
+        const_iterator copy(*this);
+        ++it;
+        return copy;
+      }
+      const_iterator &operator--() noexcept {
+        --it;
+        return *this;
+      }
+      const_iterator operator--(int) noexcept {
+        const_iterator copy(*this);
+        --it;
+        return copy;
+      }
+      constexpr bool operator==(const const_iterator &rhs) const noexcept {
+        return it == rhs.it;
+      }
+      constexpr bool operator!=(const const_iterator &rhs) const noexcept {
+        return it != rhs.it;
+      }
+    };
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using element_type = ef_element;
+
+    const_iterator begin() const { return cbegin(); }
+    const_iterator end() const { return cend(); }
+    const_iterator cbegin() const noexcept { return const_iterator(1); }
+    const_iterator cend() const noexcept { return const_iterator(size + 1); }
+    const_reverse_iterator rbegin() const { return crbegin(); }
+    const_reverse_iterator rend() const { return crend(); }
+    const_reverse_iterator crbegin() const noexcept {
+      return const_reverse_iterator(cend());
+    }
+    const_reverse_iterator crend() const noexcept {
+      return const_reverse_iterator(cbegin());
+    }
+    friend std::ostream &operator<<(std::ostream &os, const ef &ef) {
+      for (const auto &e : ef) {
+        os << e << "(" << static_cast<unsigned long>(e.value) << ")"
+           << std::endl;
+      }
+      return os;
+    }
+  };
+
+  friend ef;
+  storage_type value = 0;
+
+  static constexpr base_type beta =
+      base_type(static_cast<base_storage>(Modular_Polynomial::value),
+                gf::unchecked_tag{});
+
+  constexpr base_type low() const noexcept {
+    return base_type(static_cast<base_storage>(value & base_order),
+                     gf::unchecked_tag{});
+  }
+  constexpr base_type high() const noexcept {
+    return base_type(static_cast<base_storage>(value >> k),
+                     gf::unchecked_tag{});
+  }
+
+  static ef_element make(const base_type &a, const base_type &b) noexcept {
+    const auto low_ = static_cast<base_storage>(a);
+    const auto high_ = static_cast<base_storage>(b);
+    return ef_element(static_cast<storage_type>(storage_type(high_) << k |
+                                                storage_type(low_)),
+                      gf::unchecked_tag{});
+  }
+
+  /* x^(2^k) */
+  ef_element conjugate() const noexcept { return make(low() + high(), high()); }
+
+  base_type norm() const noexcept {
+    const base_type a = low();
+    const base_type b = high();
+    return a * (a + b) + beta * b * b;
+  }
+
+  ef_element pow(uint64_t exponent) const noexcept {
+    ef_element result(1, gf::unchecked_tag{});
+    ef_element base(*this);
+    for (; exponent; exponent >>= 1) {
+      if (exponent & 1)
+        result *= base;
+      base *= base;
+    }
+    return result;
+  }
+
+  /* prime factors of 2^Power - 1 */
+  static std::array<uint64_t, 16> order_factors() noexcept {
+    std::array<uint64_t, 16> factors{};
+    size_t count = 0;
+    uint64_t remainder = n;
+    for (uint64_t p = 3; p * p <= remainder; p += 2) {
+      if (remainder % p == 0) {
+        factors[count++] = p;
+        while (remainder % p == 0)
+          remainder /= p;
+      }
+    }
+    if (remainder > 1)
+      factors[count++] = remainder;
+    return factors;
+  }
+
+  /* smallest primitive element by storage value */
+  static ef_element generator() noexcept {
+    const auto factors = order_factors();
+    for (uint64_t candidate = 2;; candidate++) {
+      const ef_element x(static_cast<storage_type>(candidate),
+                         gf::unchecked_tag{});
+      if (std::all_of(std::cbegin(factors), std::cend(factors),
+                      [&](const uint64_t p) {
+            return !p || x.pow(n / p) != ef_element(1, gf::unchecked_tag{});
+          }))
+        return x;
+    }
+  }
+
+  static uint64_t inverse_mod(const uint64_t a, const uint64_t m) noexcept {
+    /* extended euclid; a and m are coprime */
+    int64_t t = 0, new_t = 1;
+    int64_t r = static_cast<int64_t>(m), new_r = static_cast<int64_t>(a % m);
+    while (new_r) {
+      const int64_t quotient = r / new_r;
+      t = t - quotient * new_t;
+      std::swap(t, new_t);
+      r = r - quotient * new_r;
+      std::swap(r, new_r);
+    }
+    return static_cast<uint64_t>(t < 0 ? t + static_cast<int64_t>(m) : t);
+  }
+
+  static tables_type init_tables() noexcept {
+    tables_type tables;
+    const ef_element alpha = generator();
+
+    ef_element digit_base = alpha;
+    for (auto &powers : tables.powers) {
+      ef_element power(1, gf::unchecked_tag{});
+      for (auto &entry : powers) {
+        entry = power.value;
+        power *= digit_base;
+      }
+      /* digit_base^256 */
+      digit_base = power;
+    }
+
+    const ef_element gamma = alpha.conjugate() / alpha;
+    ef_element baby(1, gf::unchecked_tag{});
+    for (uint32_t j = 0; j < baby_steps; j++) {
+      tables.baby[j] = std::make_pair(baby.value, j);
+      baby *= gamma;
+    }
+    std::sort(std::begin(tables.baby), std::end(tables.baby));
+    tables.giant = baby.inverse().value;
+
+    tables.norm_log_inverse = inverse_mod(alpha.norm().power(), base_order);
+    return tables;
+  }
+
+  static const tables_type &tables() noexcept {
+    static const tables_type tables_ = init_tables();
+    return tables_;
+  }
+
+public:
+  using field_type = ef;
+  static constexpr size_t digits = Power;
+
+  ef_element() = default;
+  /* Validates v; use this constructor for values from outside the field. */
+  constexpr explicit ef_element(const storage_type &v) : value(v) {
+    if (value & ~n)
+      throw std::runtime_error("Value is not an element of the field.");
+  }
+  /* For values known to be elements of the field, i.e. from arithmetic. */
+  constexpr ef_element(const storage_type &v, gf::unchecked_tag) noexcept
+      : value(v) {}
+  template <typename Mp, typename A>
+  constexpr explicit ef_element(const ef_element<2, 1, Mp, A> &e)
+      : value(e ? 1 : 0) {}
+
+  static ef_element from_power(unsigned power) noexcept {
+    const auto &powers = tables().powers;
+    uint64_t exponent = power % n;
+    ef_element result(powers[0][exponent & 0xff], gf::unchecked_tag{});
+    for (size_t digit = 1; digit < power_digits; digit++) {
+      exponent >>= 8;
+      result *= ef_element(powers[digit][exponent & 0xff], gf::unchecked_tag{});
+    }
+    return result;
+  }
+
+  unsigned power() const noexcept {
+    if (!value)
+      return 0;
+
+    const tables_type &tables_ = tables();
+    /* log mod 2^k - 1 from the norm, which is a power of N(α) */
+    const uint64_t e1 =
+        norm().power() * tables_.norm_log_inverse % base_order;
+
+    /* log mod 2^k + 1 from x^(2^k - 1) = γ^log */
+    const ef_element giant(tables_.giant, gf::unchecked_tag{});
+    ef_element u = conjugate() / *this;
+    uint64_t e2 = 0;
+    for (uint64_t i = 0; i <= baby_steps; i++) {
+      const auto it = std::lower_bound(
+          std::cbegin(tables_.baby), std::cend(tables_.baby),
+          std::make_pair(u.value, uint32_t(0)));
+      if (it != std::cend(tables_.baby) && it->first == u.value) {
+        e2 = (i * baby_steps + it->second) % norm_order;
+        break;
+      }
+      u *= giant;
+    }
+
+    /* CRT; (2^k - 1)^-1 = 2^(k - 1) mod 2^k + 1 */
+    const uint64_t t = (e2 + norm_order - e1 % norm_order) % norm_order *
+                       (uint64_t(1) << (k - 1)) % norm_order;
+    return static_cast<unsigned>(e1 + base_order * t);
+  }
+
+  ef_element operator+(const ef_element &rhs) const noexcept {
+    return ef_element(static_cast<storage_type>(value ^ rhs.value),
+                      gf::unchecked_tag{});
+  }
+
+  ef_element operator-(const ef_element &rhs) const noexcept {
+    return *this + rhs;
+  }
+
+  /* Karatsuba; three multiplications in GF(2^k) and one by β */
+  ef_element operator*(const ef_element &rhs) const noexcept {
+    const base_type a = low(), b = high();
+    const base_type c = rhs.low(), d = rhs.high();
+    const base_type ac = a * c;
+    const base_type bd = b * d;
+    return make(ac + beta * bd, (a + b) * (c + d) + ac);
+  }
+
+  /* Division by zero is a precondition violation. */
+  ef_element operator/(const ef_element &rhs) const noexcept {
+    assert(rhs.value != 0);
+    return *this * rhs.inverse();
+  }
+
+  ef_element inverse() const noexcept {
+    assert(value != 0);
+    const base_type inverse_norm = base_type(1, gf::unchecked_tag{}) / norm();
+    return make((low() + high()) * inverse_norm, high() * inverse_norm);
+  }
+
+  ef_element &operator*=(const ef_element &rhs) noexcept {
+    *this = *this * rhs;
+    return *this;
+  }
+
+  ef_element &operator+=(const ef_element &rhs) noexcept {
+    *this = *this + rhs;
+    return *this;
+  }
+
+  ef_element &operator++() noexcept {
+    *this = *this + ef_element(1, gf::unchecked_tag{});
+    return *this;
+  }
+
+  ef_element operator++(int) noexcept {
+    ef_element result(*this);
+    ++(*this);
+    return result;
+  }
+
+  bool operator<(const ef_element &rhs) const noexcept {
+    /* x < 0 is false */
+    if (!rhs.value)
+      return false;
+    /* 0 < !0 is true */
+    if (!value)
+      return true;
+    /* sort by power */
+    return power() < rhs.power();
+  }
+  bool operator!=(const ef_element &rhs) const noexcept {
+    return value != rhs.value;
+  }
+  bool operator==(const ef_element &rhs) const noexcept {
+    return value == rhs.value;
+  }
+
+  explicit operator bool() const noexcept { return value != 0; }
+  explicit operator storage_type() const noexcept { return value; }
+  explicit operator unsigned long() const noexcept { return value; }
+  explicit operator unsigned long long() const noexcept { return value; }
+  explicit operator int() const noexcept { return static_cast<int>(value); }
+  explicit operator float() const noexcept {
+    return static_cast<float>(value);
+  }
+
+  friend std::ostream &operator<<(std::ostream &os, const ef_element &e) {
+    if (e.value == 0)
+      return os << 0;
+    else
+      return os << "α^" << e.power();
+  }
+};
+
+template <long Power, typename Mp>
+constexpr typename ef_element<2, Power, Mp, gf::tower_tag>::base_type
+    ef_element<2, Power, Mp, gf::tower_tag>::beta;
+}
@@ -62,6 +62,42 @@ static std::vector<decoder> decoders{
   cyclic::primitive_bch<7, dmin<5>, cyclic::euklid_tag>(),
   cyclic::primitive_bch<7, dmin<7>, cyclic::euklid_tag>(),
   cyclic::primitive_bch<7, dmin<9>, cyclic::euklid_tag>(),
+  cyclic::primitive_bch<5, dmin<3>, cyclic::simplified_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<5, dmin<5>, cyclic::simplified_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<5, dmin<7>, cyclic::simplified_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<5, dmin<9>, cyclic::simplified_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<6, dmin<3>, cyclic::simplified_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<6, dmin<5>, cyclic::simplified_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<6, dmin<7>, cyclic::simplified_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<6, dmin<9>, cyclic::simplified_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<7, dmin<3>, cyclic::simplified_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<7, dmin<5>, cyclic::simplified_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<7, dmin<7>, cyclic::simplified_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<7, dmin<9>, cyclic::simplified_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<
+      5, dmin<3>, cyclic::reformulated_inversionless_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<
+      5, dmin<5>, cyclic::reformulated_inversionless_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<
+      5, dmin<7>, cyclic::reformulated_inversionless_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<
+      5, dmin<9>, cyclic::reformulated_inversionless_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<
+      6, dmin<3>, cyclic::reformulated_inversionless_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<
+      6, dmin<5>, cyclic::reformulated_inversionless_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<
+      6, dmin<7>, cyclic::reformulated_inversionless_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<
+      6, dmin<9>, cyclic::reformulated_inversionless_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<
+      7, dmin<3>, cyclic::reformulated_inversionless_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<
+      7, dmin<5>, cyclic::reformulated_inversionless_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<
+      7, dmin<7>, cyclic::reformulated_inversionless_berlekamp_massey_tag>(),
+  cyclic::primitive_bch<
+      7, dmin<9>, cyclic::reformulated_inversionless_berlekamp_massey_tag>(),
   cyclic::primitive_bch<5, dmin<3>, min_sum_tag<50> >(),
   cyclic::primitive_bch<5, dmin<5>, min_sum_tag<50> >(),
   cyclic::primitive_bch<5, dmin<7>, min_sum_tag<50> >(),
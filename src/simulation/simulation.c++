@@ -51,6 +51,7 @@ static std::array<double, 131> limits = {
     6.651,  6.837,  7.072,  7.378,  7.864 }
 };
 
+decoder::workspace_concept::~workspace_concept() = default;
 decoder::decoder_concept::~decoder_concept() = default;
 
 static constexpr double ebno(const double rate) {
@@ -97,6 +98,8 @@ void awgn_simulation::operator()() {
   const size_t ebno_width = 6;
   std::ofstream log_file(open_file(decoder.to_string() + ".log"));
   std::vector<float> b(decoder.n());
+  std::vector<decoder::return_type> result(decoder.n());
+  auto workspace = decoder.make_workspace();
 
   log_file << std::setw(ebno_width + 1) << "ebno"
            << " ";
@@ -123,14 +126,12 @@ void awgn_simulation::operator()() {
 
     for (size_t i = 0; i < iterations; i++) {
       std::generate(std::begin(b), std::end(b), noise);
-      try {
-        auto result = decoder.correct(b);
-        if (std::any_of(std::cbegin(result), std::cend(result),
-                        [](const auto &bit) { return bool(bit); })) {
-          word_errors++;
-        }
-      }
-      catch (const decoding_failure &) {
+      const auto status = decoder.correct_into(
+          vector_view<const float>(b.data(), b.size()),
+          vector_view<decoder::return_type>(result.data(), result.size()),
+          workspace);
+      if (!status || std::any_of(std::cbegin(result), std::cend(result),
+                                 [](const auto &bit) { return bool(bit); })) {
         word_errors++;
       }
     }
@@ -164,6 +165,9 @@ void bitflip_simulation::operator()() const {
   log_file << std::setw(wer_width + 6) << "wer" << std::endl;
 
   const size_t length = decoder.n();
+  std::vector<float> x(length);
+  std::vector<decoder::return_type> result(length);
+  auto workspace = decoder.make_workspace();
 
   for (size_t error = 0; error <= errors; error++) {
     size_t patterns = 0;
@@ -179,21 +183,16 @@ void bitflip_simulation::operator()() const {
     auto start = std::chrono::high_resolution_clock::now();
 
     do {
-      std::vector<float> x;
-      x.reserve(length);
-
-      std::transform(std::cbegin(b), std::cend(b), std::back_inserter(x),
+      std::transform(std::cbegin(b), std::cend(b), std::begin(x),
                      [](const auto &bit) { return -2 * bit + 1; });
 
       patterns++;
-      try {
-        auto result = decoder.correct(x);
-        if (std::any_of(std::cbegin(result), std::cend(result),
-                        [](const auto &bit) { return bool(bit); })) {
-          word_errors++;
-        }
-      }
-      catch (const decoding_failure &) {
+      const auto status = decoder.correct_into(
+          vector_view<const float>(x.data(), x.size()),
+          vector_view<decoder::return_type>(result.data(), result.size()),
+          workspace);
+      if (!status || std::any_of(std::cbegin(result), std::cend(result),
+                                 [](const auto &bit) { return bool(bit); })) {
         word_errors++;
       }
     } while (std::next_permutation(std::begin(b), std::end(b)));
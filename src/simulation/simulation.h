@@ -18,15 +18,35 @@
 
 /* TODO: InputSequence concept. */
 
+#include "codes/codes.h"
 #include "math/galois.h"
+#include "math/matrix.h"
 
 class decoder {
+public:
   using return_type = math::ef_element<2, 1>;
+
+private:
+  /* the workspace of the decoder model, see correct_into() */
+  class workspace_concept {
+  public:
+    virtual ~workspace_concept();
+  };
+
+  template <typename W> class workspace_model : public workspace_concept {
+  public:
+    W value;
+  };
+
   class decoder_concept {
   public:
     virtual ~decoder_concept();
     virtual std::vector<return_type>
     correct(const std::vector<float> &b) const = 0;
+    virtual decode_status correct_into(vector_view<const float> b,
+                                       vector_view<return_type> out,
+                                       workspace_concept &ws) const = 0;
+    virtual std::unique_ptr<workspace_concept> make_workspace() const = 0;
     virtual std::string to_string() const = 0;
     virtual double rate() const = 0;
     virtual unsigned n() const = 0;
@@ -44,6 +64,15 @@ class decoder {
         override {
       return implementation.template correct<return_type>(b);
     }
+    decode_status correct_into(vector_view<const float> b,
+                               vector_view<return_type> out,
+                               workspace_concept &ws) const override {
+      using W = workspace_model<typename T::workspace>;
+      return implementation.correct_into(b, out, static_cast<W &>(ws).value);
+    }
+    std::unique_ptr<workspace_concept> make_workspace() const override {
+      return std::make_unique<workspace_model<typename T::workspace> >();
+    }
     std::string to_string() const override {
       return implementation.to_string();
     }
@@ -55,6 +84,15 @@ class decoder {
   std::shared_ptr<const decoder_concept> _self;
 
 public:
+  /* Scratch space of one thread, for the decoder that made it only */
+  class workspace {
+    friend class decoder;
+    std::unique_ptr<workspace_concept> self;
+
+    explicit workspace(std::unique_ptr<workspace_concept> self_)
+        : self(std::move(self_)) {}
+  };
+
   template <typename T>
   decoder(T decoder)
       : _self(std::make_shared<decoder_model<T> >(std::move(decoder))) {}
@@ -63,6 +101,17 @@ public:
   std::vector<return_type> correct(const InputSequence &b) const {
     return _self->correct(b);
   }
+  workspace make_workspace() const {
+    return workspace(_self->make_workspace());
+  }
+  /* correct() into the n() elements of out, without allocating memory once
+   * the buffers of ws have grown. Decoding failures are returned, not thrown;
+   * out is only written if decoding succeeds. */
+  decode_status correct_into(vector_view<const float> b,
+                             vector_view<return_type> out,
+                             workspace &ws) const {
+    return _self->correct_into(b, out, *ws.self);
+  }
   std::string to_string() const { return _self->to_string(); }
   double rate() const { return _self->rate(); }
   unsigned n() const { return _self->n(); }
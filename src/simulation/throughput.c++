@@ -0,0 +1,450 @@
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <sstream>
+#include <algorithm>
+
+#include <getopt.h>
+#include <cstdlib>
+
+#include "codes/bch.h"
+#include "codes/rs.h"
+#include "math/gaussian_elimination.h"
+
+/* Decodes words with t random bit errors using the free-standing building
+ * blocks of the cyclic codes (syndromes, Berlekamp-Massey, root search), so
+ * that the arithmetic backend of the field can be exchanged. */
+template <unsigned q, unsigned t, typename Arithmetic>
+static double decode_throughput(const size_t words, const uint64_t seed) {
+  using Element = math::ef_element<
+      2, q, typename math::detail::default_modular_polynomial<q>::type,
+      Arithmetic>;
+  using Polynomial = math::polynomial<Element>;
+  constexpr unsigned n = (1 << q) - 1;
+
+  std::mt19937_64 generator(seed);
+  std::uniform_int_distribution<unsigned> position(0, n - 1);
+
+  std::vector<Element> roots;
+  for (unsigned power = 1; power < 2 * t + 1; power++)
+    roots.push_back(Element::from_power(power));
+
+  std::vector<Polynomial> received;
+  received.reserve(words);
+  for (size_t word = 0; word < words; word++) {
+    Polynomial b(n, Element(0));
+    for (unsigned error = 0; error < t; error++)
+      b.at(position(generator)) = Element(1);
+    received.push_back(b);
+  }
+
+  size_t found = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (const auto &b : received) {
+    const auto syndromes = cyclic::calculate_syndromes(b, roots);
+    const auto sigma = cyclic::error_locator_polynomial<Polynomial>(
+        syndromes, std::vector<unsigned>(), cyclic::berlekamp_massey_tag{});
+    found += math::gf::roots<typename Element::field_type>(
+                 sigma, math::gf::brute_force_tag{}).size();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  if (found == 0)
+    std::cerr << "No errors located." << std::endl;
+
+  return words / std::chrono::duration<double>(end - start).count();
+}
+
+template <unsigned q, unsigned t>
+static void compare_arithmetic(const size_t words, const uint64_t seed) {
+  const double table =
+      decode_throughput<q, t, math::gf::log_table_tag>(words, seed);
+  const double clmul = decode_throughput<q, t, math::gf::clmul_tag>(words, seed);
+
+  std::ostringstream code;
+  code << "(" << ((1 << q) - 1) << ", t = " << t << ")";
+  std::cout << std::setw(16) << code.str() << std::setw(12) << std::fixed
+            << std::setprecision(0) << table << std::setw(12) << clmul
+            << std::endl;
+}
+
+/* Evaluates a polynomial of the given degree at all elements of the field,
+ * i.e. the brute-force root search. Returns ns per multiply-add. */
+template <typename Element>
+static double root_search(const unsigned degree, const uint64_t seed) {
+  using Polynomial = math::polynomial<Element>;
+  using storage_type = typename Element::storage_type;
+
+  std::mt19937_64 generator(seed);
+  const typename Element::field_type field;
+  const size_t size = static_cast<size_t>(
+      std::distance(std::cbegin(field), std::cend(field)));
+
+  Polynomial p;
+  for (unsigned i = 0; i <= degree; i++)
+    p.push_back(Element(static_cast<storage_type>(generator() % size)));
+
+  size_t zeroes = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (const auto &element : field)
+    zeroes += !p(element);
+  auto end = std::chrono::high_resolution_clock::now();
+
+  if (zeroes > degree)
+    std::cerr << "Too many zeroes." << std::endl;
+
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         (size * degree);
+}
+
+template <typename Binary, typename Prime>
+static void compare_fields(const std::string &name, const uint64_t seed) {
+  constexpr unsigned degree = 32;
+  const double binary = root_search<Binary>(degree, seed);
+  const double prime = root_search<Prime>(degree, seed);
+
+  std::cout << std::setw(16) << name << std::setw(12) << std::fixed
+            << std::setprecision(2) << binary << std::setw(12) << prime
+            << std::endl;
+}
+
+/* Finds the t zeroes of random error locators. Returns µs per search. */
+template <typename Element, typename Tag>
+static double locator_roots(const unsigned t, const size_t searches,
+                            const uint64_t seed) {
+  using Polynomial = math::polynomial<Element>;
+
+  std::mt19937_64 generator(seed);
+  std::uniform_int_distribution<unsigned> position(0, (1u << Element::digits) - 2);
+
+  std::vector<Polynomial> locators;
+  locators.reserve(searches);
+  for (size_t search = 0; search < searches; search++) {
+    Polynomial sigma({ Element(1) });
+    std::vector<unsigned> positions;
+    while (positions.size() < t) {
+      const unsigned p = position(generator);
+      if (std::find(std::cbegin(positions), std::cend(positions), p) !=
+          std::cend(positions))
+        continue;
+      positions.push_back(p);
+      sigma *= Polynomial({ Element(1), Element::from_power(p) });
+    }
+    locators.push_back(sigma);
+  }
+
+  size_t zeroes = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (const auto &sigma : locators)
+    zeroes += math::gf::roots<typename Element::field_type>(sigma, Tag{}).size();
+  auto end = std::chrono::high_resolution_clock::now();
+
+  if (zeroes != t * searches)
+    std::cerr << "Zeroes are missing." << std::endl;
+
+  return std::chrono::duration<double, std::micro>(end - start).count() /
+         searches;
+}
+
+template <unsigned q, unsigned t>
+static void compare_root_search(const size_t searches, const uint64_t seed) {
+  using Element = math::ef_element<2, q>;
+  const double brute_force = locator_roots<Element, math::gf::brute_force_tag>(
+      t, searches, seed);
+  const double chien =
+      locator_roots<Element, math::gf::chien_tag>(t, searches, seed);
+  const double trace =
+      locator_roots<Element, math::gf::berlekamp_trace_tag>(t, searches, seed);
+  const double fft =
+      locator_roots<Element, math::gf::additive_fft_tag>(t, searches, seed);
+
+  std::ostringstream code;
+  code << "(" << ((1 << q) - 1) << ", t = " << t << ")";
+  std::cout << std::setw(16) << code.str() << std::setw(12) << std::fixed
+            << std::setprecision(2) << brute_force << std::setw(12) << chien
+            << std::setw(12) << trace << std::setw(12) << fft << std::endl;
+}
+
+/* Corrects words with the given number of random bit errors with a complete
+ * decoder. */
+template <typename Code>
+static double correct_throughput(const Code &code, const size_t words,
+                                 const unsigned errors, const uint64_t seed) {
+  std::mt19937_64 generator(seed);
+  std::uniform_int_distribution<unsigned> position(0, Code::n - 1);
+
+  std::vector<std::vector<uint8_t> > received;
+  received.reserve(words);
+  for (size_t word = 0; word < words; word++) {
+    std::vector<uint8_t> b(Code::n, 0);
+    for (unsigned error = 0; error < errors; error++)
+      b.at(position(generator)) = 1;
+    received.push_back(b);
+  }
+
+  size_t failures = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (const auto &b : received) {
+    try {
+      const auto corrected = code.correct(b);
+      failures += std::any_of(std::cbegin(corrected), std::cend(corrected),
+                              [](const auto &e) { return e != 0; });
+    } catch (const decoding_failure &) {
+      failures++;
+    }
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  if (failures)
+    std::cerr << failures << " words were not corrected." << std::endl;
+
+  return words / std::chrono::duration<double>(end - start).count();
+}
+
+template <typename Code>
+static void long_code(const size_t words, const uint64_t seed) {
+  const Code code;
+  const double t_errors = correct_throughput(code, words, Code::t, seed);
+  const double one_error = correct_throughput(code, words, 1, seed);
+  const double no_errors = correct_throughput(code, words, 0, seed);
+
+  std::ostringstream name;
+  name << "(" << Code::n << ", t = " << Code::t << ")";
+  std::cout << std::setw(16) << name.str() << std::setw(12) << std::fixed
+            << std::setprecision(0) << t_errors << std::setw(12) << one_error
+            << std::setw(12) << no_errors << std::endl;
+}
+
+/* Eliminates a random size x size matrix over GF(2), with one element per
+ * column or packed by M4RI. Returns ms per elimination. */
+template <typename System, typename Set>
+static double elimination(const size_t size, const uint64_t seed, Set &&set) {
+  std::mt19937_64 generator(seed);
+  System system(size, size);
+  for (size_t row = 0; row < size; row++) {
+    for (size_t column = 0; column < size; column++)
+      set(system, row, column, generator() & 1);
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  const size_t rank = system.eliminate();
+  auto end = std::chrono::high_resolution_clock::now();
+
+  if (rank + 16 < size)
+    std::cerr << "Rank " << rank << " of a random matrix." << std::endl;
+
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static void compare_elimination(const size_t size, const uint64_t seed) {
+  using Element = math::ef_element<2, 1>;
+  const double elements = elimination<math::dense_system<Element> >(
+      size, seed, [](math::dense_system<Element> &system, const size_t row,
+                     const size_t column, const bool value) {
+        system[row][column] = Element(value);
+      });
+  const double packed = elimination<math::gf2_system>(
+      size, seed, [](math::gf2_system &system, const size_t row,
+                     const size_t column, const bool value) {
+        system.set(row, column, value);
+      });
+
+  std::ostringstream name;
+  name << size << " x " << size;
+  std::cout << std::setw(16) << name.str() << std::setw(12) << std::fixed
+            << std::setprecision(2) << elements << std::setw(12) << packed
+            << std::endl;
+}
+
+/* Error values of RS codes by a linear equation system and by Forney's
+ * algorithm, for words with t symbol errors. */
+template <unsigned q, unsigned t>
+static void compare_error_values(const size_t words, const uint64_t seed) {
+  using Naive = cyclic::rs<q, errors<t>, cyclic::berlekamp_massey_tag,
+                           (1 << q) - 1, cyclic::division_tag, 1, 1,
+                           cyclic::naive_tag>;
+  using Forney = cyclic::rs<q, errors<t>, cyclic::berlekamp_massey_tag>;
+  const double naive = correct_throughput(Naive(), words, t, seed);
+  const double forney = correct_throughput(Forney(), words, t, seed);
+
+  std::ostringstream code;
+  code << "(" << Forney::n << ", t = " << t << ")";
+  std::cout << std::setw(16) << code.str() << std::setw(12) << std::fixed
+            << std::setprecision(0) << naive << std::setw(12) << forney
+            << std::endl;
+}
+
+/* Encodes random information words of symbols with the given number of bits.
+ * Returns information Mbit/s. */
+template <typename Code>
+static double encode_throughput(const unsigned bits, const size_t words,
+                                const uint64_t seed) {
+  const Code code;
+  const auto l = static_cast<size_t>(code.rate * Code::n + 0.5);
+
+  std::mt19937_64 generator(seed);
+  std::vector<std::vector<uint8_t> > information;
+  information.reserve(words);
+  for (size_t word = 0; word < words; word++) {
+    std::vector<uint8_t> a(l);
+    for (auto &symbol : a)
+      symbol = static_cast<uint8_t>(generator() & ((1u << bits) - 1));
+    information.push_back(a);
+  }
+
+  std::vector<uint8_t> c(Code::n);
+  size_t parity = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (const auto &a : information) {
+    code.encode(a, std::begin(c));
+    parity += c.front();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  if (!parity)
+    std::cerr << "All code words start with 0." << std::endl;
+
+  return words * l * bits / std::chrono::duration<double>(end - start).count() /
+         1e6;
+}
+
+template <typename Division, typename Generator_matrix, typename Multiplication>
+static void compare_encoders(const unsigned bits, const size_t words,
+                             const uint64_t seed) {
+  const double division = encode_throughput<Division>(bits, words, seed);
+  const double matrix = encode_throughput<Generator_matrix>(bits, words, seed);
+  const double multiplication =
+      encode_throughput<Multiplication>(bits, words, seed);
+
+  std::ostringstream code;
+  code << (bits == 1 ? "BCH" : "RS") << "(" << Division::n
+       << ", t = " << Division::t << ")";
+  std::cout << std::setw(20) << code.str() << std::setw(12) << std::fixed
+            << std::setprecision(0) << division << std::setw(12) << matrix
+            << std::setw(12) << multiplication << std::endl;
+}
+
+[[noreturn]] static void usage() {
+  std::cout << "--words <num>    "
+            << "  "
+            << "Number of words decoded per code. The default is 20000."
+            << std::endl;
+  std::cout << "--seed <num>     "
+            << "  "
+            << "Set seed of the random number generator." << std::endl;
+  std::exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *const argv[]) {
+  size_t words = 20000;
+  uint64_t seed = 0;
+
+  while (1) {
+    static struct option options[] = {
+      { "words", required_argument, nullptr, 'w' },
+      { "seed", required_argument, nullptr, 's' },
+      { nullptr, 0, nullptr, 0 },
+    };
+
+    int option_index = 0;
+    int c = getopt_long_only(argc, argv, "", options, &option_index);
+    if (c == -1)
+      break;
+
+    switch (c) {
+    case 'w':
+      words = std::stoull(optarg);
+      break;
+    case 's':
+      seed = std::stoull(optarg);
+      break;
+    default:
+      std::cerr << "Unkown argument: " << c << " " << std::endl;
+      usage();
+    }
+  }
+
+  std::cout << "Decoded words/s" << std::endl;
+  std::cout << std::setw(16) << "code" << std::setw(12) << "log/exp"
+            << std::setw(12) << "clmul" << std::endl;
+  compare_arithmetic<5, 3>(words, seed);
+  compare_arithmetic<6, 4>(words, seed);
+  compare_arithmetic<7, 4>(words, seed);
+  compare_arithmetic<8, 8>(words, seed);
+
+  std::cout << std::endl << "Corrected words/s" << std::endl;
+  std::cout << std::setw(16) << "code" << std::setw(12) << "t errors"
+            << std::setw(12) << "1 error" << std::setw(12) << "no errors"
+            << std::endl;
+  long_code<cyclic::primitive_bch<10, errors<20>,
+                                  cyclic::berlekamp_massey_tag> >(words / 10,
+                                                                  seed);
+  long_code<cyclic::primitive_bch<13, errors<40>,
+                                  cyclic::berlekamp_massey_tag> >(words / 100,
+                                                                  seed);
+  long_code<cyclic::primitive_bch<18, errors<3>,
+                                  cyclic::berlekamp_massey_tag> >(words / 1000,
+                                                                  seed);
+
+  std::cout << std::endl << "Corrected RS words/s" << std::endl;
+  std::cout << std::setw(16) << "code" << std::setw(12) << "naive"
+            << std::setw(12) << "Forney" << std::endl;
+  compare_error_values<4, 3>(words, seed);
+  compare_error_values<8, 8>(words / 10, seed);
+  compare_error_values<8, 16>(words / 10, seed);
+
+  std::cout << std::endl << "Gaussian elimination over GF(2), ms" << std::endl;
+  std::cout << std::setw(16) << "matrix" << std::setw(12) << "elements"
+            << std::setw(12) << "M4RI" << std::endl;
+  compare_elimination(256, seed);
+  compare_elimination(1024, seed);
+
+  std::cout << std::endl << "Encoded information Mbit/s" << std::endl;
+  std::cout << std::setw(20) << "code" << std::setw(12) << "LFSR"
+            << std::setw(12) << "G" << std::setw(12) << "a * g" << std::endl;
+  compare_encoders<
+      cyclic::primitive_bch<8, errors<8>, cyclic::berlekamp_massey_tag>,
+      cyclic::primitive_bch<8, errors<8>, cyclic::berlekamp_massey_tag, 255,
+                            cyclic::generator_matrix_tag>,
+      cyclic::primitive_bch<8, errors<8>, cyclic::berlekamp_massey_tag, 255,
+                            cyclic::multiplication_tag> >(1, words, seed);
+  compare_encoders<
+      cyclic::primitive_bch<10, errors<20>, cyclic::berlekamp_massey_tag>,
+      cyclic::primitive_bch<10, errors<20>, cyclic::berlekamp_massey_tag, 1023,
+                            cyclic::generator_matrix_tag>,
+      cyclic::primitive_bch<10, errors<20>, cyclic::berlekamp_massey_tag, 1023,
+                            cyclic::multiplication_tag> >(1, words / 4, seed);
+  compare_encoders<
+      cyclic::rs<8, errors<8>, cyclic::berlekamp_massey_tag>,
+      cyclic::rs<8, errors<8>, cyclic::berlekamp_massey_tag, 255,
+                 cyclic::generator_matrix_tag>,
+      cyclic::rs<8, errors<8>, cyclic::berlekamp_massey_tag, 255,
+                 cyclic::multiplication_tag> >(8, words / 10, seed);
+
+  std::cout << std::endl << "Zeroes of Σ(x), µs per search" << std::endl;
+  std::cout << std::setw(16) << "code" << std::setw(12) << "brute force"
+            << std::setw(12) << "Chien" << std::setw(12) << "trace"
+            << std::setw(12) << "FFT" << std::endl;
+  compare_root_search<8, 2>(words / 10, seed);
+  compare_root_search<8, 8>(words / 10, seed);
+  compare_root_search<10, 20>(words / 10, seed);
+  compare_root_search<13, 4>(words / 100, seed);
+  compare_root_search<13, 40>(words / 100, seed);
+
+  std::cout << std::endl << "Root search, ns per multiply-add" << std::endl;
+  std::cout << std::setw(16) << "field" << std::setw(12) << "GF(2^m)"
+            << std::setw(12) << "GF(p)" << std::endl;
+  compare_fields<math::ef_element<2, 8>, math::ef_element<251, 1> >(
+      "2^8 / 251", seed);
+  compare_fields<math::ef_element<2, 16>, math::ef_element<65521, 1> >(
+      "2^16 / 65521", seed);
+  compare_fields<math::ef_element<2, 18>, math::ef_element<262139, 1> >(
+      "2^18 / 262139", seed);
+  compare_fields<math::ef_element<2, 20>, math::ef_element<1048573, 1> >(
+      "2^20 / 1048573", seed);
+  compare_fields<math::ef_element<2, 8>, math::ef_element<3, 5> >("2^8 / 3^5",
+                                                                   seed);
+}